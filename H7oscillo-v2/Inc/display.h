@@ -14,11 +14,59 @@
 #include "main.h"
 
 
+#define DMA2D_QUEUE_LEN			64			/* max no. of pending DMA2D jobs (power of 2) */
+#define DMA2D_NUM_BANKS			4			/* SDRAM banks tracked for buffer fences */
+
+#define RGB565_TO_ARGB1555(c)	(0x8000 | (((c) >> 11) << 10) | ((((c) >> 6) & 0x1F) << 5) | ((c) & 0x1F))
+
+/* DMA2D transfer (register values loaded when the job is started) */
+typedef struct{
+	uint32_t CR;
+	uint32_t FGMAR;
+	uint32_t FGOR;
+	uint32_t FGPFCCR;
+	uint32_t FGCOLR;
+	uint32_t BGMAR;
+	uint32_t BGOR;
+	uint32_t BGPFCCR;
+	uint32_t OPFCCR;
+	uint32_t OCOLR;
+	uint32_t OMAR;
+	uint32_t OOR;
+	uint32_t NLR;
+} DMA2DJob_t;
+
+#define GLYPH_CACHE_FONTS		3			/* no. of fonts pre-rendered into the glyph atlas */
+
+/* Font rendered into the glyph atlas */
+typedef struct{
+	const unsigned char* p;				/* font data (identifies the font) */
+	uint32_t addr;						/* atlas address of the first glyph */
+} GlyphCache_t;
+
+uint32_t DMA2D_submit(const DMA2DJob_t* job);
+void DMA2D_processQueue(void);
+uint8_t DMA2D_isFenceDone(uint32_t fence);
+void DMA2D_waitFence(uint32_t fence);
+void DMA2D_waitBuffer(uint32_t addr);
+void DMA2D_waitIdle(void);
+
 void pset(UG_S16 x, UG_S16 y, UG_COLOR color);
-void clearScreen(void);
-void fillScreenWave(UG_COLOR color);
+uint32_t clearScreen(void);
+uint32_t fillScreenWave(uint8_t idx);
+void drawSpanWave(UG_S16 x, UG_S16 y1, UG_S16 y2, uint8_t idx);
+void drawEnvelopeWave(const uint8_t* emin, const uint8_t* emax, uint8_t ch, int32_t bot, int32_t sigmax, uint8_t idx);
+void fillRectWave(UG_S16 x1, UG_S16 y1, UG_S16 x2, UG_S16 y2, uint8_t idx);
+uint32_t scrollDownWave(UG_S16 y1, UG_S16 y2, UG_S16 n);
+void drawXYWave(const uint8_t* xs, const uint8_t* ys, uint32_t len, const uint16_t* colLUT, const uint16_t* rowLUT, uint8_t lines, uint8_t persist);
+void decayWave(UG_S16 y1, UG_S16 y2, uint8_t step);
 UG_RESULT fillFrameUGUI(UG_S16 x1, UG_S16 y1, UG_S16 x2, UG_S16 y2, UG_COLOR color);
 UG_RESULT drawLineUGUI(UG_S16 x1, UG_S16 y1, UG_S16 x2, UG_S16 y2, UG_COLOR color);
-void updateToScreen(void);
+uint32_t overlayUGUI(uint32_t src, UG_S16 x1, UG_S16 y1, UG_S16 x2, UG_S16 y2);
+void initGlyphCache(void);
+UG_RESULT drawCharUGUI(UG_U8 chr, UG_S16 x, UG_S16 y, UG_COLOR fc, UG_COLOR bc, const UG_FONT* font);
+void initWavePalette(void);
+void setWavePalette(uint8_t idx, UG_COLOR color);
+uint32_t updateToScreen(void);
 
 #endif /* __DISPLAY_H */
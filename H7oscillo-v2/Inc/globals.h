@@ -72,6 +72,7 @@
 #define CHDISPMODE_MERGE	1
 #define CHDISPMODE_SNGL		2		/* ch1 only */
 #define CHDISPMODE_FFT		3
+#define CHDISPMODE_XY		4		/* ch1 (horizontal) vs ch2 (vertical) */
 
 #define CHDISPMODE_SPLIT_SIGMAX		119
 #define CHDISPMODE_SPLIT_CH1BOT		134
@@ -83,11 +84,55 @@
 #define CHDISPMODE_MERGE_CHBOT		254
 #define CHDISPMODE_MERGE_CHTOP		(CHDISPMODE_MERGE_CHBOT - CHDISPMODE_MERGE_SIGMAX)
 
+#define CHDISPMODE_XY_XSTART		((LCD_WIDTH - CHDISPMODE_MERGE_SIGMAX - 1)/2)	/* left edge of the square XY plot */
+
+/* Spectrum views (in CHDISPMODE_FFT) */
+#define FFTVIEW_SPECTRUM	0
+#define FFTVIEW_WFALL		1		/* waterfall (spectrogram) */
+
+#define FFT_ZOOM_MAX		6		/* spectrum span down to (fs/2)/2^FFT_ZOOM_MAX */
+
+/* Spectrum windows */
+#define FFTWIN_RECT			0
+#define FFTWIN_HANN			1
+#define FFTWIN_BLKHARRIS	2		/* 4-term Blackman-Harris */
+#define FFTWIN_FLATTOP		3
+#define FFTWIN_NUM			4
+
+#define FFT_AVG_MAX			6		/* power averaging over up to 2^FFT_AVG_MAX frames */
+
+#define FFTHOLD_MAX			0x01	/* max-hold trace */
+#define FFTHOLD_MIN			0x02	/* min-hold trace */
+
+#define FFTENGINE_FLOAT		0		/* float chirp-z transform */
+#define FFTENGINE_Q15		1		/* q15 real FFT for the full span, float chirp-z when zoomed */
+
+#define FFTPEAKS_OFF		0
+#define FFTPEAKS_TABLE		1		/* peak table */
+#define FFTPEAKS_HARM		2		/* peak table and harmonic markers */
+#define FFT_HARM_MARKERS	10		/* markers at up to this multiple of the strongest peak */
+
 #define MATH_OP_NONE		0
 #define MATH_OP_1P2			1
 #define MATH_OP_1M2			2
 #define MATH_OP_2M1			3
 #define MATH_OP_1X2			4
+#define MATH_OP_CH1			5		/* a single channel, for the functions */
+#define MATH_OP_CH2			6
+#define MATH_OP_NUM			7
+
+#define MATH_FN_NONE		0		/* function applied to the operation result */
+#define MATH_FN_INTEG		1		/* integral, in code x divisions */
+#define MATH_FN_DIFF		2		/* derivative, in codes per division */
+#define MATH_FN_ABS			3
+#define MATH_FN_INV			4		/* scaled by -1 */
+#define MATH_FN_X2			5
+#define MATH_FN_X10			6
+#define MATH_FN_MID			7		/* offset by half scale, to bring a difference into the 0..3.3V range */
+#define MATH_FN_NUM			8
+
+#define MATH_FILT_OFF		0		/* low-pass filter before the function, cutoff fs/2^(mathFilt + 1) */
+#define MATH_FILT_MAX		3
 
 #define MATHVSCALE_INITVAL	5
 #define MATHVOFF_INITVAL	210
@@ -111,6 +156,7 @@ extern uint32_t SystemCoreClock;
 
 extern __IO uint8_t CH1_ADC_vals[ADC_BUF_SIZE];
 extern __IO uint8_t CH2_ADC_vals[ADC_BUF_SIZE];
+extern uint32_t acqSeq;
 
 extern uint8_t vscale1;				/* Vertical scale of channel 1 */
 extern uint8_t vscale2;				/* Vertical scale of channel 2 */
@@ -148,15 +194,27 @@ extern __IO uint8_t DMA2D_error_flag;
 
 extern uint8_t staticMode;
 extern int32_t toffStm;
-extern uint8_t vscale1Changed, vscale2Changed, voff1Changed, voff2Changed, toffChanged;
+extern uint8_t vscale1Changed, vscale2Changed, voff1Changed, voff2Changed, toffChanged, mathChanged;
+extern uint8_t stmZoomView;
 
 extern uint8_t chDispMode;
 
 extern uint8_t fftSrcChannel;
+extern uint8_t fftView;
+extern uint8_t fftZoom;
+extern float32_t fftCenter;
+extern uint8_t fftWindow;
+extern uint8_t fftAvg;
+extern uint8_t fftHold;
+extern uint8_t fftEngine;
+extern uint8_t fftPeaks;
+extern uint8_t xyPersist, xyLines;
 
 extern uint8_t mathOp;
 extern uint8_t mathVscale;
 extern int16_t mathVoff;
+extern uint8_t mathFn;
+extern uint8_t mathFilt;
 
 extern uint8_t scrnshtViewMode;
 
@@ -17,6 +17,7 @@ extern void TimQE_init(void);
 extern void TimADC_init(int8_t tbase);
 extern void TimTS_init(void);
 void TimMeas_init(void);
+void CycleCounter_init(void);
 extern void ADC_init(void);
 extern void ADC_Ch1_init(void);
 void ADC_Ch1_reinit(void);
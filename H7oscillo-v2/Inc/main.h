@@ -156,6 +156,11 @@
 #define LCD_DRAW_BUFFER_WAVE					SDRAM_BANK2_ADDR		/* Draw buffer for the waveforms */
 #define UGUI_FRAME_ALPHA						0x8F					/* Blending Alpha factor for the uGUI Layer */
 #define WAVE_FRAME_ALPHA						0xFF					/* Blending Alpha factor for the Wave Layer */
+#define WFALL_SCROLL_BUFFER						(SDRAM_BANK2_ADDR + 0x00040000)	/* Intermediate copy of the waterfall while scrolling (L8) */
+#define GRID_SURFACE_SPLIT						(SDRAM_BANK1_ADDR + 0x00040000)	/* Pre-rendered grid overlays (ARGB1555), split mode */
+#define GRID_SURFACE_MERGE						(SDRAM_BANK1_ADDR + 0x00080000)	/* merge/single mode */
+#define GRID_SURFACE_FFT						(SDRAM_BANK1_ADDR + 0x000C0000)	/* spectrum mode (vertical lines only) */
+#define GLYPH_ATLAS_BUFFER						(SDRAM_BANK1_ADDR + 0x00100000)	/* Pre-rendered A8 font glyphs (read only by uGUI draws) */
 
 /* SDRAM Bank 3 used as scratch buffers (general work area) */
 #define SCRATCH_BUFFER0							((uint32_t)0xC0600000)
@@ -166,6 +171,8 @@
 #define DISKIO_BUFFER							SCRATCH_BUFFER0			/* Buffer for Flash(Disk) IO operations  */
 #define USB_DATA_BUFFER							SCRATCH_BUFFER1			/* Buffer for USB packet data */
 #define BMP_BUFFER								SCRATCH_BUFFER2			/* Buffer for storing the converted BMP image */
+#define MEAS_WORK_BUFFER						SCRATCH_BUFFER3			/* Work area for the cross-channel measurements */
+#define CZT_WORK_BUFFER							(SCRATCH_BUFFER3 + 0x00010000)	/* Chirp-z transform plan cache and work area */
 
 #define MAX_SCRNSHOTS							50						/* max screenshots that can be saved */
 
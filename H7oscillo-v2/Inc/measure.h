@@ -28,18 +28,166 @@
 #define MEAS_VMIN		5		/* min */
 #define MEAS_VPP		6		/* peak-peak */
 #define MEAS_VAVG		7		/* average */
+#define MEAS_PER		8		/* period */
+#define MEAS_RISE		9		/* rise time (10-90%) */
+#define MEAS_FALL		10		/* fall time (90-10%) */
+#define MEAS_PWID		11		/* positive width (at 50%) */
+#define MEAS_NWID		12		/* negative width (at 50%) */
+#define MEAS_OVSH		13		/* overshoot */
+#define MEAS_PRSH		14		/* preshoot */
+#define MEAS_DLY		15		/* delay of CH2 w.r.t. CH1 */
+#define MEAS_PHS		16		/* phase of CH2 w.r.t. CH1 */
+#define MEAS_THD		17		/* total harmonic distortion */
+#define MEAS_SNR		18		/* signal to noise ratio */
+#define MEAS_SINAD		19		/* signal to noise and distortion ratio */
+#define MEAS_ENOB		20		/* effective no. of bits */
+#define MEAS_SFDR		21		/* spurious free dynamic range */
+#define MEAS_LAST		MEAS_SFDR
+
+#define MEAS_HARMONICS_MAX	10		/* max. harmonic order summed into THD */
+
+#define XCORR_LEN		4096	/* cross-correlation FFT length, >= 2*ADC_BUF_SIZE for a linear correlation */
+
+#define CZT_MAX_LEN		4096	/* max. chirp-z transform FFT length, i.e. max. N + M - 1 */
+#define CZT_NUM_PLANS	3		/* no. of chirp-z transform plans cached */
+#define CZT_PLAN_SIZE	(4*CZT_MAX_LEN + 4)	/* floats per cached plan: chirps (N + M complex) and filter FFT (L complex) */
+#define CZT_RESEED		16		/* chirp values generated by rotation between exact ones */
+
+#define SPECTRUM_BINS	480		/* spectrum points, one per display column */
+#define FFT_PEAKS_MAX	5		/* no. of spectrum peaks tracked (peak table rows) */
+#define RFFT_Q15_LEN	1024	/* q15 spectrum real FFT length, >= ADC_TRIGBUF_SIZE */
+
+#define ZC_MIN_AMPLITUDE	10		/* min. peak-peak (counts) for the crossing frequency counter */
+#define ZC_HYST_DIV			4		/* hysteresis thresholds at mid -/+ peak-peak/ZC_HYST_DIV */
+#define ZC_MIN_CROSSINGS	3		/* i.e. at least 2 full cycles */
+#define ZC_MAX_PERIOD_SPREAD	0.3f	/* max. (longest - shortest cycle)/mean cycle */
+
+#define MEAS_CACHE_STATS	0x01	/* cached results of a channel */
+#define MEAS_CACHE_FREQ		0x02
+#define MEAS_CACHE_DUTY		0x04
+#define MEAS_CACHE_PULSE	0x08
+#define MEAS_CACHE_SPECTRAL	0x10
+
+#define MEAS_GATE_MIN_LEN	8	/* min. no. of samples measured between the dT cursors */
+
+#define PULSE_HIST_WINDOW	5	/* no. of adjacent codes counted together when finding top & base */
+
+#define PULSE_UNKNOWN	0		/* edge state machine states */
+#define PULSE_LOW		1
+#define PULSE_RISING	2
+#define PULSE_HIGH		3
+#define PULSE_FALLING	4
+
+typedef struct{
+	uint32_t n;				/* no. of acquisitions accumulated */
+	float32_t last;			/* values in display units (Hz, s, ADC counts, %, deg) */
+	float32_t mean;
+	float32_t m2;			/* sum of squared deviations from the mean (Welford) */
+	float32_t min;
+	float32_t max;
+} MeasAccum_TypeDef;
 
 typedef struct{
 	uint8_t src;
 	uint8_t param;
+	MeasAccum_TypeDef acc;
 } Measure_TypeDef;
 
-extern uint8_t chSpectrum[ADC_TRIGBUF_SIZE];
+typedef struct{
+	uint8_t min;
+	uint8_t max;
+	uint32_t sum;
+	uint32_t sumsq;
+} Stats_TypeDef;
+
+typedef struct{
+	float32_t rise;			/* mean rise time (samples), -1 if no complete rising edge */
+	float32_t fall;			/* mean fall time (samples), -1 if no complete falling edge */
+	float32_t pwid;			/* mean positive width (samples), -1 if none */
+	float32_t nwid;			/* mean negative width (samples), -1 if none */
+	float32_t ovsh;			/* overshoot (% of top - base) */
+	float32_t prsh;			/* preshoot (% of top - base) */
+} Pulse_TypeDef;
+
+typedef struct{
+	float32_t freq;			/* as a fraction of fs */
+	float32_t level;		/* dB above the bottom of the spectrum plot */
+} SpectrumPeak_TypeDef;
+
+typedef struct{
+	float32_t thd;			/* dB, all NAN if no fundamental found */
+	float32_t snr;			/* dB */
+	float32_t sinad;		/* dB */
+	float32_t enob;			/* bits */
+	float32_t sfdr;			/* dBc */
+	uint8_t harmonics;		/* measHarmonics the results were calculated with */
+	uint8_t window;			/* fftWindow the results were calculated with */
+} Spectral_TypeDef;
+
+typedef struct{
+	const uint8_t* ch1;		/* CH1 samples on screen */
+	const uint8_t* ch2;		/* CH2 samples on screen */
+	const uint8_t* math;	/* math samples on screen */
+	uint32_t len;			/* no. of samples in ch1/ch2/math */
+	float32_t idx0;			/* sample index at screen column 0 */
+	float32_t step;			/* samples per screen column */
+	uint32_t samprate;		/* sample rate of ch1/ch2/math */
+	uint32_t caprate;		/* sample rate of the capture */
+} MeasView_TypeDef;
+
+typedef struct{
+	uint32_t seq;			/* acquisition the results belong to */
+	uint32_t gen;			/* measurement view/gate the results belong to */
+	uint32_t mathGen;		/* math signal the results belong to (math source only) */
+	uint8_t valid;			/* MEAS_CACHE_xxx flags of the results calculated so far */
+	Stats_TypeDef stats;
+	float32_t freq;
+	uint8_t duty;
+	Pulse_TypeDef pulse;
+	Spectral_TypeDef spectral;
+} MeasCache_TypeDef;
+
+typedef struct{
+	uint32_t N;				/* no. of input points */
+	uint32_t M;				/* no. of output points */
+	float32_t f1;			/* frequency range as fractions of fs */
+	float32_t f2;
+	uint8_t window;			/* FFTWIN_xxx */
+	uint32_t L;				/* FFT length, power of 2 >= N + M - 1 (0 = unused plan) */
+	uint32_t lastUse;		/* for replacing the least recently used plan */
+	float32_t* pre;			/* A^-n * W^(n^2/2) (windowed), N complex */
+	float32_t* post;		/* W^(k^2/2), M complex */
+	float32_t* filt;		/* FFT of W^(-n^2/2), L complex */
+	arm_cfft_instance_f32 S;
+} CztPlan_TypeDef;
+
+typedef struct{
+	uint8_t type;			/* FFTWIN_xxx */
+	uint32_t len;			/* 0 = not generated yet */
+	float32_t gain;			/* coherent gain, i.e. mean of the window */
+	float32_t* w;
+} Window_TypeDef;
+
+extern uint8_t chSpectrum[SPECTRUM_BINS];
+extern uint8_t chSpectrumMax[SPECTRUM_BINS], chSpectrumMin[SPECTRUM_BINS];
+extern uint32_t spectrumCycles;
+extern SpectrumPeak_TypeDef spectrumPeaks[FFT_PEAKS_MAX];
+extern uint8_t spectrumPeakCnt;
 extern const char measParamTexts[][5];
 extern Measure_TypeDef measure1, measure2, measure3, measure4;
+extern uint8_t measStatsOn;
+extern uint8_t measHarmonics;
 
 void measure_init(void);
 float32_t calcMeasure(uint8_t channel, uint8_t param);
-void calcSpectrum(uint8_t channel);
+float32_t scaleMeasure(uint8_t param, float32_t val);
+void calcMeasurements(void);
+void accumulateMeasurements(void);
+void resetMeasStats(Measure_TypeDef* meas);
+void setMeasView(const uint8_t* ch1, const uint8_t* ch2, const uint8_t* math, uint32_t len, float32_t idx0, float32_t step, uint32_t samprate, uint32_t caprate);
+void setMeasGate(uint8_t on, uint16_t colA, uint16_t colB);
+void calcSpectrum(uint8_t channel, uint32_t offset, uint32_t len, uint8_t accumulate);
+float32_t spectrumFreq(float32_t bin);
+float32_t spectrumBin(float32_t freq);
 
 #endif /* __MEASURE_H */
@@ -12,6 +12,7 @@
 #define CHANNELNONE			 0			/* Input channels */
 #define CHANNEL1			 1
 #define CHANNEL2			 2
+#define CHANNELMATH			 3			/* math waveform, as a source for the spectrum */
 
 #define TOFF_LIMIT			 6			/* horizontal offset limit (on both sides of screen) */
 
@@ -22,6 +23,9 @@
 							  ADC_PRETRIGBUF_SIZE + \
 							  ADC_POSTRIGBUF_SIZE				/* Size of ADC sampling buffer */
 
+#define WFALL_ROWS_PER_CAPTURE	 3			/* spectrogram rows computed from each capture */
+#define WFALL_WINDOW_HOP	 	 ((ADC_BUF_SIZE - ADC_TRIGBUF_SIZE)/(WFALL_ROWS_PER_CAPTURE - 1))	/* sample step between the rows' windows */
+
 #define UGUI_MAX_OBJECTS     10			/* uGUI max objects in a window */
 
 #endif /* __PARAMS_H */
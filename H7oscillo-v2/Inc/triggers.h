@@ -23,6 +23,15 @@
 #define MAX_RESAMPLEDSIG_LEN2		2494					/* Max length of the resampled signal output of filter 2, including room for next stage */
 #define MAX_PREPEND_LEN2			50						/* Max length of prepended samples in filter 2 */
 #define MAX_PREPEND_LEN3			10						/* Max length of prepended samples in filter 3 */
+#define MAX_ENVELOPE_LEN			480						/* Max no. of min/max envelope columns (screen width) */
+#define MINMAX_PYR_LEVELS			9						/* min/max pyramid levels, block sizes 4, 8, ..., 1024 samples */
+#define MINMAX_PYR_SIZE				((ADC_BUF_SIZE)/2)		/* total no. of blocks of all levels */
+#define MATH_FIR_TAPS				63						/* math low-pass filter length, odd for an integer delay */
+#define MATH_FIR_DELAY				((MATH_FIR_TAPS - 1)/2)
+#define MATH_FIR_BLOCK				64						/* samples filtered per call */
+#define MATH_DIV_SAMPLES			(LCD_WIDTH/GRID_HORZ_DIVS)	/* samples per horizontal division, the time unit of the integral/derivative */
+#define MATH_ZERO					128						/* 8-bit math sample of a zero result */
+#define MATH_LSB					2						/* ADC codes per 8-bit math sample step, for a range of +/-3.3V */
 
 typedef struct {
 	uint8_t type;
@@ -33,9 +42,21 @@ typedef struct {
 
 extern uint8_t CH1_ResampledVals[MAX_RESAMPLEDSIG_LEN];
 extern uint8_t CH2_ResampledVals[MAX_RESAMPLEDSIG_LEN];
+extern uint8_t MATH_ResampledVals[MAX_RESAMPLEDSIG_LEN];
+extern uint8_t CH1_EnvMin[MAX_ENVELOPE_LEN], CH1_EnvMax[MAX_ENVELOPE_LEN];
+extern uint8_t CH2_EnvMin[MAX_ENVELOPE_LEN], CH2_EnvMax[MAX_ENVELOPE_LEN];
+extern uint8_t MATH_EnvMin[MAX_ENVELOPE_LEN], MATH_EnvMax[MAX_ENVELOPE_LEN];
+extern uint8_t MATH_vals[ADC_BUF_SIZE];
+extern uint32_t mathGen;
 
 int32_t processTriggers(void);
 int32_t chkTrigResampSig(int32_t len);
 int32_t resampleChannels(uint32_t offset, uint32_t lenx, uint8_t origSR, uint8_t newSR);
+void buildMinMaxPyramid(void);
+void queryMinMax(uint8_t ch, int32_t start, int32_t end, uint8_t* pmin, uint8_t* pmax);
+void envelopeChannels(float32_t start, float32_t spc);
+void decimateMinMax(const uint8_t* x, uint32_t lenx, uint8_t* xmin, uint8_t* xmax, uint32_t ncols);
+void minMaxSumU8(const uint8_t* x, uint32_t len, uint8_t* pmin, uint8_t* pmax, uint32_t* psum, uint32_t* psumsq);
+void calcMath(const uint8_t* ch1, const uint8_t* ch2, uint32_t len);
 
 #endif /* __TRIGGERS_H */
@@ -549,10 +549,11 @@ typedef struct
 #define DRIVER_ENABLED                                (1<<1)
 
 /* Supported drivers */
-#define NUMBER_OF_DRIVERS                             3
+#define NUMBER_OF_DRIVERS                             4
 #define DRIVER_DRAW_LINE                              0
 #define DRIVER_FILL_FRAME                             1
 #define DRIVER_FILL_AREA                              2
+#define DRIVER_DRAW_CHAR                              3
 
 /* -------------------------------------------------------------------------------- */
 /* -- µGUI CORE STRUCTURE                                                        -- */
@@ -924,6 +925,9 @@ UG_RESULT UG_WindowCreate( UG_WINDOW* wnd, UG_OBJECT* objlst, UG_U8 objcnt, void
 UG_RESULT UG_WindowDelete( UG_WINDOW* wnd );
 UG_RESULT UG_WindowShow( UG_WINDOW* wnd );
 UG_RESULT UG_WindowHide( UG_WINDOW* wnd );
+UG_RESULT UG_WindowSetVisible( UG_WINDOW* wnd, UG_U8 visible );
+UG_RESULT UG_WindowInvalidate( UG_WINDOW* wnd );
+void UG_WindowUpdate( UG_WINDOW* wnd );
 UG_RESULT UG_WindowResize( UG_WINDOW* wnd, UG_S16 xs, UG_S16 ys, UG_S16 xe, UG_S16 ye );
 UG_RESULT UG_WindowAlert( UG_WINDOW* wnd );
 UG_RESULT UG_WindowSetForeColor( UG_WINDOW* wnd, UG_COLOR fc );
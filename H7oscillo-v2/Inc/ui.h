@@ -24,12 +24,46 @@
 #define WINDOW8				 8
 #define WINDOW9				 9
 #define WINDOW10			 10
+#define WINDOW12			 12
+
+/* Compositor slots, i.e. drawing order of the windows (window 11 is drawn by displayInfo) */
+#define SLOT_WINDOW1		 0
+#define SLOT_WINDOW2		 1
+#define SLOT_WINDOW3		 2
+#define SLOT_WINDOW4		 3
+#define SLOT_WINDOW5		 4
+#define SLOT_WINDOW6		 5
+#define SLOT_WINDOW7		 6
+#define SLOT_WINDOW8		 7
+#define SLOT_WINDOW9		 8
+#define SLOT_WINDOW10		 9
+#define SLOT_WINDOW12		 10
+#define NUM_UI_WINDOWS		 11					/* windows drawn by the compositor */
 
 /* Colors and dimensions of GUI elements */
 #define CH1_COLOR			 	 	C_GREEN				/* colors of CH1 waveform and related parameter displays */
 #define CH2_COLOR			 	 	C_AQUA				/* colors of CH2 waveform and related parameter displays */
 #define FFT_COLOR					C_MEDIUM_ORCHID		/* spectrum color */
 #define MATH_COLOR					C_MEDIUM_ORCHID		/* math waveform color */
+#define FFTMAX_COLOR				C_GOLD				/* spectrum max-hold trace color */
+#define FFTMIN_COLOR				C_DEEP_SKY_BLUE		/* spectrum min-hold trace color */
+#define HARMONIC_COLOR				C_ORANGE			/* spectrum harmonic marker color */
+
+/* Wave layer (L8) palette indices, see initWavePalette() */
+#define WAVE_IDX_BG					0					/* wave layer background (black) */
+#define WAVE_IDX_CH1				1					/* CH1 waveform (CH1_COLOR) */
+#define WAVE_IDX_CH2				2					/* CH2 waveform (CH2_COLOR) */
+#define WAVE_IDX_MATH				3					/* math waveform (MATH_COLOR) */
+#define WAVE_IDX_FFT				4					/* spectrum (FFT_COLOR) */
+#define WAVE_IDX_ZOOMBOX			5					/* zoom box of the static mode overview (ZOOMBOX_COLOR) */
+#define WAVE_IDX_SEPARATOR			6					/* overview/magnified view separator (CH_SEPARATOR_COLOR) */
+#define WAVE_IDX_FFTMAX				7					/* spectrum max-hold trace (FFTMAX_COLOR) */
+#define WAVE_IDX_FFTMIN				8					/* spectrum min-hold trace (FFTMIN_COLOR) */
+#define WAVE_IDX_HARMONIC			9					/* spectrum harmonic markers (HARMONIC_COLOR) */
+#define WAVE_IDX_RAMP				128					/* first entry of the intensity ramp */
+#define WAVE_RAMP_LEVELS			128					/* no. of intensity levels (WAVE_IDX_RAMP..255) */
+#define XY_PERSIST_HIT				24					/* intensity levels added per XY plot hit */
+#define XY_PERSIST_DECAY			4					/* intensity levels lost per frame */
 #define TBASE_ICON_COLOR	 	 	C_YELLOW			/* color of the time base icon */
 #define MODE_ICON_COLOR		 	 	C_MEDIUM_ORCHID		/* color of the Mode icon */
 #define RUNSTOP_ICON_COLOR_RUN	 	C_YELLOW_GREEN		/* color of the Run/Stop icon for Run state */
@@ -47,28 +81,33 @@
 #define GRID_COLOR			 	 	C_DARK_GRAY			/* grid color */
 #define CH_SEPARATOR_POS			135					/* channel separator position */
 #define CH_SEPARATOR_COLOR		 	C_WHITE				/* channel separator color */
+#define ZOOMBOX_COLOR		 		C_DARK_SLATE_GRAY	/* static mode zoom box color */
 #define WIND3_WIDTH	 		 	 	80					/* window 3 & 4 width */
 #define WIND3_BTN_SPACING	 	 	10					/* window 3 & 4 vertical spacing between buttons */
 #define WIND3_BTN_HEIGHT	 	 	30					/* window 3 & 4 button heights */
 #define WIND5_WIDTH	 		 	 	140					/* window 5 width */
-#define WIND5_HEIGHT	 	 	 	60					/* window 5 height */
+#define WIND5_HEIGHT	 	 	 	175					/* window 5 height */
 #define WIND5_BTN_SPACING	 	 	5					/* window 5 vertical spacing between buttons */
 #define WIND5_BTN_WIDTH	 	 		60					/* window 5 button widths */
 #define WIND5_BTN_HEIGHT	 	 	20					/* window 5 button heights */
+#define WIND5_STATS_Y_START	 	 	126					/* window 5 statistics panel Y start (relative) */
+#define WIND5_STATS_LINE_HEIGHT	 	11					/* window 5 statistics panel line height */
 #define WIND5_X_START	 	 	 	250					/* window 5 X start position */
-#define WIND5_Y_START	 	 	 	90					/* window 5 Y start position */
+#define WIND5_Y_START	 	 	 	65					/* window 5 Y start position */
 #define WIND6_WIDTH	 		 	 	140					/* window 6 width */
-#define WIND6_HEIGHT	 	 	 	30					/* window 6 height */
+#define WIND6_HEIGHT	 	 	 	105					/* window 6 height */
+#define WIND6_BTN_SPACING	 	 	5					/* window 6 vertical spacing between buttons */
 #define WIND6_BTN_WIDTH	 	 		60					/* window 6 button widths */
 #define WIND6_BTN_HEIGHT	 	 	20					/* window 6 button heights */
 #define WIND6_X_START	 	 	 	250					/* window 6 X start position */
 #define WIND6_Y_START	 	 	 	90					/* window 6 Y start position */
 #define WIND7_WIDTH	 		 	 	140					/* window 7 width */
-#define WIND7_HEIGHT	 	 	 	30					/* window 7 height */
+#define WIND7_HEIGHT	 	 	 	204					/* window 7 height */
+#define WIND7_BTN_SPACING	 	 	4					/* window 7 vertical spacing between buttons */
 #define WIND7_BTN_WIDTH	 	 		60					/* window 7 button widths */
-#define WIND7_BTN_HEIGHT	 	 	20					/* window 7 button heights */
+#define WIND7_BTN_HEIGHT	 	 	18					/* window 7 button heights */
 #define WIND7_X_START	 	 	 	250					/* window 7 X start position */
-#define WIND7_Y_START	 	 	 	90					/* window 7 Y start position */
+#define WIND7_Y_START	 	 	 	50					/* window 7 Y start position */
 #define WIND8_WIDTH	 		 	 	70					/* window 8 width */
 #define WIND8_HEIGHT	 	 	 	15					/* window 8 height */
 #define WIND8_BTN_WIDTH	 	 		65					/* window 8 button widths */
@@ -76,14 +115,14 @@
 #define WIND8_X_START	 	 	 	(TOFF_INITVAL + 10)	/* window 8 X start position */
 #define WIND8_Y_START	 	 	 	20					/* window 8 Y start position */
 #define WIND9_WIDTH	 		 	 	140					/* window 9 width */
-#define WIND9_HEIGHT	 	 	 	80					/* window 9 height */
+#define WIND9_HEIGHT	 	 	 	130					/* window 9 height */
 #define WIND9_BTN_SPACING	 	 	5					/* window 9 vertical spacing between buttons */
 #define WIND9_BTN_WIDTH	 	 		60					/* window 9 button widths */
 #define WIND9_BTN_HEIGHT	 	 	20					/* window 9 button heights */
 #define WIND9_X_START	 	 	 	250					/* window 9 X start position */
 #define WIND9_Y_START	 	 	 	90					/* window 9 Y start position */
 #define WIND10_WIDTH	 		 	140					/* window 10 width */
-#define WIND10_HEIGHT	 	 	 	160					/* window 10 height */
+#define WIND10_HEIGHT	 	 	 	165					/* window 10 height */
 #define WIND10_BTN_SPACING1			5					/* window 10 vertical spacing 1 between buttons */
 #define WIND10_BTN_SPACING2			25					/* window 10 vertical spacing 2 between buttons */
 #define WIND10_BTN_WIDTH	 	 	60					/* window 10 button widths */
@@ -94,6 +133,11 @@
 #define WIND11_HEIGHT	 	 	 	40					/* window 11 height */
 #define WIND11_X_START	 	 	 	150					/* window 11 X start position */
 #define WIND11_Y_START	 	 	 	70					/* window 11 Y start position */
+#define WIND12_WIDTH	 		 	110					/* window 12 width */
+#define WIND12_HEIGHT	 	 	 	(FFT_PEAKS_MAX*WIND12_LINE_HEIGHT + 4)	/* window 12 height */
+#define WIND12_LINE_HEIGHT	 	 	11					/* window 12 line height */
+#define WIND12_X_START	 	 	 	5					/* window 12 X start position */
+#define WIND12_Y_START	 	 	 	40					/* window 12 Y start position */
 #define CURSOR_LENGTH	 	 	 	13					/* length of trigger and vertical offset cursors */
 #define CURSOR_WIDTH	 	 	 	10					/* width of trigger and vertical offset cursors */
 #define TOFF_CURSOR_LENGTH	 	 	10					/* length of horizontal offset cursors */
@@ -161,38 +205,77 @@ extern UG_BUTTON button4_2;
 extern UG_BUTTON button4_3;
 extern UG_BUTTON button4_4;
 extern UG_WINDOW window_5;
-extern UG_OBJECT obj_buff_wnd_5[4];
+extern UG_OBJECT obj_buff_wnd_5[14];
 extern UG_TEXTBOX txtb5_0;
 extern UG_TEXTBOX txtb5_1;
+extern UG_TEXTBOX txtb5_2;
+extern UG_TEXTBOX txtb5_3;
+extern UG_TEXTBOX txtb5_4;
+extern UG_TEXTBOX txtb5_5;
+extern UG_TEXTBOX txtb5_6;
+extern UG_TEXTBOX txtb5_7;
+extern UG_TEXTBOX txtb5_8;
 extern UG_BUTTON button5_0;
 extern UG_BUTTON button5_1;
+extern UG_BUTTON button5_2;
+extern UG_BUTTON button5_3;
+extern UG_BUTTON button5_4;
 extern UG_WINDOW window_6;
-extern UG_OBJECT obj_buff_wnd_6[2];
+extern UG_OBJECT obj_buff_wnd_6[8];
 extern UG_TEXTBOX txtb6_0;
+extern UG_TEXTBOX txtb6_1;
+extern UG_TEXTBOX txtb6_2;
+extern UG_TEXTBOX txtb6_3;
 extern UG_BUTTON button6_0;
+extern UG_BUTTON button6_1;
+extern UG_BUTTON button6_2;
+extern UG_BUTTON button6_3;
 extern UG_WINDOW window_7;
-extern UG_OBJECT obj_buff_wnd_7[2];
+extern UG_OBJECT obj_buff_wnd_7[18];
 extern UG_TEXTBOX txtb7_0;
+extern UG_TEXTBOX txtb7_1;
+extern UG_TEXTBOX txtb7_2;
+extern UG_TEXTBOX txtb7_3;
+extern UG_TEXTBOX txtb7_4;
+extern UG_TEXTBOX txtb7_5;
+extern UG_TEXTBOX txtb7_6;
+extern UG_TEXTBOX txtb7_7;
+extern UG_TEXTBOX txtb7_8;
 extern UG_BUTTON button7_0;
+extern UG_BUTTON button7_1;
+extern UG_BUTTON button7_2;
+extern UG_BUTTON button7_3;
+extern UG_BUTTON button7_4;
+extern UG_BUTTON button7_5;
+extern UG_BUTTON button7_6;
+extern UG_BUTTON button7_7;
+extern UG_BUTTON button7_8;
 extern UG_WINDOW window_8;
 extern UG_OBJECT obj_buff_wnd_8[1];
 extern UG_TEXTBOX txtb8_0;
 extern UG_WINDOW window_9;
-extern UG_OBJECT obj_buff_wnd_9[6];
+extern UG_OBJECT obj_buff_wnd_9[10];
 extern UG_TEXTBOX txtb9_0;
 extern UG_TEXTBOX txtb9_1;
 extern UG_TEXTBOX txtb9_2;
+extern UG_TEXTBOX txtb9_3;
+extern UG_TEXTBOX txtb9_4;
 extern UG_BUTTON button9_0;
 extern UG_BUTTON button9_1;
 extern UG_BUTTON button9_2;
+extern UG_BUTTON button9_3;
+extern UG_BUTTON button9_4;
 
 char* gcvt(double value, int ndigit, char* buf);
 void initUI(void);
 void drawGrid(void);
-void voltsToStr(uint8_t val, char* buf);
+void voltsToStr(uint16_t val, char* buf);
 void hertzToStr(float32_t freq, char* buf);
 void secToStr(float32_t t, char* buf);
-void switchNextWindow(void);
+int32_t sampleToRow(int32_t val, uint8_t ch);
+int32_t sampleToRowArea(int32_t val, uint8_t ch, int32_t bot, int32_t sigmax);
+void updateWindows(void);
+void invalidateWindows(UG_S16 xs, UG_S16 ys, UG_S16 xe, UG_S16 ye);
 void clearWind4Submenus(void);
 void DisplayMeasurements(void);
 uint8_t getCurrField(void);
@@ -9,6 +9,180 @@
 /* Includes */
 #include "display.h"
 
+static void DMA2D_startJob(const DMA2DJob_t* job);
+static void DMA2D_markBuffer(uint32_t addr, uint32_t fence);
+static uint8_t DMA2D_takeError(void);
+static uint32_t rgb565to888(UG_COLOR color);
+static void plotXYPoint(__IO uint8_t* p, uint8_t persist);
+
+static DMA2DJob_t jobQueue[DMA2D_QUEUE_LEN];			/* ring buffer of pending jobs */
+static __IO uint32_t jobsSubmitted = 0;					/* total jobs queued so far (last issued fence) */
+static __IO uint32_t jobsDone = 0;						/* total jobs completed so far */
+static __IO uint8_t jobActive = 0;						/* a queued job is running on the DMA2D */
+static uint32_t bankFence[DMA2D_NUM_BANKS] = {0};		/* fence of the last job touching each SDRAM bank */
+static GlyphCache_t glyphCache[GLYPH_CACHE_FONTS];		/* fonts available in the glyph atlas */
+static uint32_t nCachedFonts = 0;
+
+
+/**
+  * @brief  Queue a DMA2D transfer. The transfer starts immediately if the DMA2D is idle,
+  * 		else it is started from the DMA2D interrupt once the previous jobs complete.
+  * @param  job: register values for the transfer
+  * @retval Fence of the queued job, to be passed to DMA2D_waitFence()
+  */
+uint32_t DMA2D_submit(const DMA2DJob_t* job)
+{
+	uint32_t fence, mode;
+
+	/* wait for a free slot in the queue */
+	while(jobsSubmitted - jobsDone >= DMA2D_QUEUE_LEN);
+
+	NVIC_DisableIRQ(DMA2D_IRQn);
+
+	jobQueue[jobsSubmitted & (DMA2D_QUEUE_LEN - 1)] = *job;
+	fence = ++jobsSubmitted;
+
+	/* record the buffers read/written by this job */
+	mode = (job->CR >> 16) & 0x03;
+	DMA2D_markBuffer(job->OMAR, fence);
+	if(mode != 0x03)
+		DMA2D_markBuffer(job->FGMAR, fence);
+	if(mode == 0x02)
+		DMA2D_markBuffer(job->BGMAR, fence);
+
+	if(!jobActive){
+		jobActive = 1;
+		DMA2D_startJob(&jobQueue[jobsDone & (DMA2D_QUEUE_LEN - 1)]);
+	}
+
+	NVIC_EnableIRQ(DMA2D_IRQn);
+
+	return fence;
+}
+
+/**
+  * @brief  Retire the finished job and start the next one in the queue (if any).
+  * 		Called from the DMA2D interrupt.
+  * @param  None
+  * @retval None
+  */
+void DMA2D_processQueue(void)
+{
+	if(!jobActive)
+		return;
+
+	jobsDone++;
+
+	if(jobsDone != jobsSubmitted){
+		DMA2D_startJob(&jobQueue[jobsDone & (DMA2D_QUEUE_LEN - 1)]);
+	}
+	else{
+		jobActive = 0;
+	}
+}
+
+/**
+  * @brief  Check if the job with the given fence has completed.
+  * @param  fence: fence returned by DMA2D_submit()
+  * @retval 1 if completed, 0 otherwise
+  */
+uint8_t DMA2D_isFenceDone(uint32_t fence)
+{
+	return ((int32_t)(jobsDone - fence) >= 0);
+}
+
+/**
+  * @brief  Wait for the job with the given fence (and all jobs before it) to complete.
+  * @param  fence: fence returned by DMA2D_submit()
+  * @retval None
+  */
+void DMA2D_waitFence(uint32_t fence)
+{
+	while((int32_t)(jobsDone - fence) < 0);
+}
+
+/**
+  * @brief  Wait for all queued jobs which read or write the given buffer to complete.
+  * 		Must be called before the CPU accesses a buffer that the DMA2D may be using.
+  * @param  addr: any address within the buffer
+  * @retval None
+  */
+void DMA2D_waitBuffer(uint32_t addr)
+{
+	uint32_t bank = (addr - SDRAM_BANK0_ADDR) >> 21;
+
+	if(bank < DMA2D_NUM_BANKS)
+		DMA2D_waitFence(bankFence[bank]);
+}
+
+/**
+  * @brief  Wait for all queued jobs to complete.
+  * @param  None
+  * @retval None
+  */
+void DMA2D_waitIdle(void)
+{
+	DMA2D_waitFence(jobsSubmitted);
+}
+
+/**
+  * @brief  Load the job registers and start the transfer.
+  * @param  job: register values for the transfer
+  * @retval None
+  */
+static void DMA2D_startJob(const DMA2DJob_t* job)
+{
+	DMA2D->CR = job->CR;
+
+	DMA2D->FGMAR = job->FGMAR;
+	DMA2D->FGOR = job->FGOR;
+	DMA2D->FGPFCCR = job->FGPFCCR;
+	DMA2D->FGCOLR = job->FGCOLR;
+
+	DMA2D->BGMAR = job->BGMAR;
+	DMA2D->BGOR = job->BGOR;
+	DMA2D->BGPFCCR = job->BGPFCCR;
+
+	DMA2D->OPFCCR = job->OPFCCR;
+	DMA2D->OCOLR = job->OCOLR;
+	DMA2D->OMAR = job->OMAR;
+	DMA2D->OOR = job->OOR;
+	DMA2D->NLR = job->NLR;
+
+	DMA2D->IFCR |= 0x3F;					/* clear all flags */
+	DMA2D->CR |= 0x01;						/* start transfer */
+}
+
+/**
+  * @brief  Record the fence of the latest job using the SDRAM bank containing the given address.
+  * @param  addr: buffer address
+  * @param  fence: job fence
+  * @retval None
+  */
+static void DMA2D_markBuffer(uint32_t addr, uint32_t fence)
+{
+	uint32_t bank = (addr - SDRAM_BANK0_ADDR) >> 21;
+
+	if(bank < DMA2D_NUM_BANKS)
+		bankFence[bank] = fence;
+}
+
+/**
+  * @brief  Read and clear the DMA2D error flag, so that each failed transfer is reported once.
+  * @param  None
+  * @retval 1 if a transfer has failed since the last call, 0 otherwise
+  */
+static uint8_t DMA2D_takeError(void)
+{
+	uint8_t err;
+
+	NVIC_DisableIRQ(DMA2D_IRQn);
+	err = DMA2D_error_flag;
+	DMA2D_error_flag = 0;
+	NVIC_EnableIRQ(DMA2D_IRQn);
+
+	return err;
+}
 
 /**
   * @brief  Set color of the given pixel (in the uGUI draw buffer).
@@ -21,57 +195,240 @@ void pset(UG_S16 x, UG_S16 y, UG_COLOR color)
 {
 	__IO uint16_t (*pFrame)[LCD_WIDTH] = (uint16_t (*)[LCD_WIDTH])LCD_DRAW_BUFFER_UGUI;
 
+	/* queued fills must land before the pixel is written */
+	DMA2D_waitBuffer(LCD_DRAW_BUFFER_UGUI);
+
 	pFrame[y][x] = color;
 }
 
 /**
   * @brief  Clears the screen (directly draws to frame buffer).
   * @param  None
+  * @retval Fence of the queued job
+  */
+uint32_t clearScreen(void)
+{
+	DMA2DJob_t job = {0};
+
+	job.CR = 0x00032300;					/* reg-memory, transfer complete/error intr enable */
+	job.OCOLR = C_BLACK;					/* color */
+
+	job.OMAR = LCD_FRAME_BUFFER;			/* output addr */
+	job.OOR = 0; 							/* output offset */
+	job.OPFCCR = 0x02;						/* output format RGB565 */
+	job.NLR = (LCD_WIDTH)<<16 |				/* frame dimensions */
+				(LCD_HEIGHT)<<0;
+
+	return DMA2D_submit(&job);
+}
+
+/**
+  * @brief  Fills the entire Wave draw buffer with the given palette index.
+  * @param  idx: palette index to fill the screen with
+  * @retval Fence of the queued job
+  */
+uint32_t fillScreenWave(uint8_t idx)
+{
+	DMA2DJob_t job = {0};
+
+	/* the L8 buffer is filled as RGB565 of half the width, two indices per pixel */
+	job.CR = 0x00032300;					/* reg-memory, transfer complete/error intr enable */
+	job.OCOLR = (idx << 8) | idx;			/* two palette indices */
+
+	job.OMAR = LCD_DRAW_BUFFER_WAVE;		/* output addr */
+	job.OOR = 0; 							/* output offset */
+	job.OPFCCR = 0x02;						/* output format RGB565 */
+	job.NLR = (LCD_WIDTH/2)<<16 |			/* frame dimensions */
+				(LCD_HEIGHT)<<0;
+
+	return DMA2D_submit(&job);
+}
+
+/**
+  * @brief  Draws a vertical span in the Wave draw buffer.
+  * @param  x: column
+  * @param  y1: start row
+  * @param  y2: end row (may be above y1)
+  * @param  idx: palette index
   * @retval None
   */
-void clearScreen(void)
+void drawSpanWave(UG_S16 x, UG_S16 y1, UG_S16 y2, uint8_t idx)
 {
-	/* wait for any ongoing transfers to complete */
-	while(DMA2D->CR & 0x01);
+	__IO uint8_t* p;
+	UG_S16 t;
 
-	DMA2D->CR = 0x00030100;					/* reg-memory, transfer error intr enable */
-	DMA2D->OCOLR = C_BLACK;					/* color */
+	if(y1 > y2){
+		t = y1;
+		y1 = y2;
+		y2 = t;
+	}
 
-	DMA2D->OMAR	= LCD_FRAME_BUFFER;			/* output addr */
-	DMA2D->OOR = 0; 						/* output offset */
-	DMA2D->OPFCCR = 0x02;					/* output format RGB565 */
-	DMA2D->NLR = (LCD_WIDTH)<<16 |			/* frame dimensions */
-					(LCD_HEIGHT)<<0;
+	p = (__IO uint8_t *)LCD_DRAW_BUFFER_WAVE + y1*LCD_WIDTH + x;
+	for(; y1 <= y2; y1++, p += LCD_WIDTH)
+		*p = idx;
+}
 
-	DMA2D->IFCR |= 0x3F;					/* clear all flags */
-	DMA2D->CR |= 0x01;						/* start transfer */
+/**
+  * @brief  Draws a min/max envelope in the Wave draw buffer as vertical spans, each joined to
+  * 		the previous drawn column to keep the trace continuous. Columns with min > max
+  * 		(outside the capture) are skipped.
+  * @param  emin: per column min. sample values
+  * @param  emax: per column max. sample values
+  * @param  ch: channel (1 or 2, 3 for math)
+  * @param  bot: bottom row of the display area
+  * @param  sigmax: max. signal height in the area
+  * @param  idx: palette index
+  * @retval None
+  */
+void drawEnvelopeWave(const uint8_t* emin, const uint8_t* emax, uint8_t ch, int32_t bot, int32_t sigmax, uint8_t idx)
+{
+	int32_t j, lo, hi, prev = -1;
 
-	while(DMA2D->CR & 0x01);
+	for(j = 0; j < LCD_WIDTH; j++){
+		if(emin[j] > emax[j])
+			continue;
+
+		lo = emin[j];
+		hi = emax[j];
+		if(prev != -1){
+			lo = min(lo, emax[prev]);
+			hi = max(hi, emin[prev]);
+		}
+		drawSpanWave(j, sampleToRowArea(lo, ch, bot, sigmax), sampleToRowArea(hi, ch, bot, sigmax), idx);
+
+		prev = j;
+	}
 }
 
 /**
-  * @brief  Fills the entire Wave draw buffer with the given color.
-  * @param  color: color to fill the screen with
+  * @brief  Fills a rectangle in the Wave draw buffer.
+  * @param  x1: start column
+  * @param  y1: start row
+  * @param  x2: end column
+  * @param  y2: end row
+  * @param  idx: palette index
   * @retval None
   */
-void fillScreenWave(UG_COLOR color)
+void fillRectWave(UG_S16 x1, UG_S16 y1, UG_S16 x2, UG_S16 y2, uint8_t idx)
 {
-	/* wait for any ongoing transfers to complete */
-	while(DMA2D->CR & 0x01);
+	__IO uint8_t* p;
+	UG_S16 x;
 
-	DMA2D->CR = 0x00030100;					/* reg-memory, transfer error intr enable */
-	DMA2D->OCOLR = color;					/* color */
+	p = (__IO uint8_t *)LCD_DRAW_BUFFER_WAVE + y1*LCD_WIDTH;
+	for(; y1 <= y2; y1++, p += LCD_WIDTH)
+		for(x = x1; x <= x2; x++)
+			p[x] = idx;
+}
 
-	DMA2D->OMAR	= LCD_DRAW_BUFFER_WAVE;		/* output addr */
-	DMA2D->OOR = 0; 						/* output offset */
-	DMA2D->OPFCCR = 0x02;					/* output format RGB565 */
-	DMA2D->NLR = (LCD_WIDTH)<<16 |			/* frame dimensions */
-					(LCD_HEIGHT)<<0;
+/**
+  * @brief  Scrolls rows y1 to y2 of the Wave draw buffer down by n rows, the bottom n rows are
+  * 		dropped and rows y1 to y1+n-1 are left as they were. The region is moved through
+  * 		WFALL_SCROLL_BUFFER, since the DMA2D cannot move overlapping lines downwards in place.
+  * @param  y1: first row
+  * @param  y2: last row
+  * @param  n: no. of rows to scroll by, less than y2 - y1 + 1
+  * @retval Fence of the last queued job
+  */
+uint32_t scrollDownWave(UG_S16 y1, UG_S16 y2, UG_S16 n)
+{
+	DMA2DJob_t job = {0};
+
+	/* the L8 rows are moved as RGB565 of half the width */
+	job.CR = 0x00002300;								/* memory-memory, transfer complete/error intr enable */
+	job.FGPFCCR = 0x02;									/* foreground format RGB565 */
+	job.FGOR = 0;										/* foreground offset */
+	job.OOR = 0;										/* output offset */
+	job.NLR = (LCD_WIDTH/2)<<16 |						/* frame dimensions */
+				(y2 - y1 + 1 - n)<<0;
+
+	job.FGMAR = LCD_DRAW_BUFFER_WAVE + y1*LCD_WIDTH;	/* rows y1 to y2-n */
+	job.OMAR = WFALL_SCROLL_BUFFER;
+	DMA2D_submit(&job);
+
+	job.FGMAR = WFALL_SCROLL_BUFFER;					/* back to rows y1+n to y2 */
+	job.OMAR = LCD_DRAW_BUFFER_WAVE + (y1 + n)*LCD_WIDTH;
+	return DMA2D_submit(&job);
+}
 
-	DMA2D->IFCR |= 0x3F;					/* clear all flags */
-	DMA2D->CR |= 0x01;						/* start transfer */
+/**
+  * @brief  Plots sample pairs (xs[n], ys[n]) into the Wave draw buffer, as dots or as connected
+  * 		segments. The sample to column/row mapping is given by lookup tables, so that the loop
+  * 		is integer-only.
+  * @param  xs: horizontal axis samples
+  * @param  ys: vertical axis samples (sample-aligned with xs)
+  * @param  len: no. of sample pairs
+  * @param  colLUT: column for each sample value
+  * @param  rowLUT: row for each sample value
+  * @param  lines: 1 to join consecutive points with line segments
+  * @param  persist: 1 to accumulate intensity (intensity ramp), 0 to draw with WAVE_IDX_CH1
+  * @retval None
+  */
+void drawXYWave(const uint8_t* xs, const uint8_t* ys, uint32_t len, const uint16_t* colLUT, const uint16_t* rowLUT, uint8_t lines, uint8_t persist)
+{
+	__IO uint8_t* pFrame = (__IO uint8_t *)LCD_DRAW_BUFFER_WAVE;
+	int32_t x0, y0, x1, y1, dx, dy, sx, sy, err, e2;
+	uint32_t n;
+
+	if(len == 0)
+		return;
+
+	DMA2D_waitBuffer(LCD_DRAW_BUFFER_WAVE);
+
+	x0 = colLUT[xs[0]];
+	y0 = rowLUT[ys[0]];
+	plotXYPoint(pFrame + y0*LCD_WIDTH + x0, persist);
+
+	for(n = 1; n < len; n++){
+		x1 = colLUT[xs[n]];
+		y1 = rowLUT[ys[n]];
+
+		if(!lines){
+			plotXYPoint(pFrame + y1*LCD_WIDTH + x1, persist);
+			continue;
+		}
+
+		/* Bresenham line from the previous point, excluding the previous point itself */
+		dx = abs(x1 - x0);
+		dy = -abs(y1 - y0);
+		sx = (x0 < x1) ? 1 : -1;
+		sy = (y0 < y1) ? 1 : -1;
+		err = dx + dy;
+		while(x0 != x1 || y0 != y1){
+			e2 = 2*err;
+			if(e2 >= dy){
+				err += dy;
+				x0 += sx;
+			}
+			if(e2 <= dx){
+				err += dx;
+				y0 += sy;
+			}
+			plotXYPoint(pFrame + y0*LCD_WIDTH + x0, persist);
+		}
+	}
+}
 
-	while(DMA2D->CR & 0x01);
+/**
+  * @brief  Fades the intensity ramp pixels of rows y1 to y2 of the Wave draw buffer, 4 pixels at a
+  * 		time (saturating bytewise subtract). Pixels that fall off the ramp are cleared.
+  * @param  y1: first row
+  * @param  y2: last row
+  * @param  step: no. of intensity levels to subtract
+  * @retval None
+  */
+void decayWave(UG_S16 y1, UG_S16 y2, uint8_t step)
+{
+	__IO uint32_t* p = (__IO uint32_t *)(LCD_DRAW_BUFFER_WAVE + y1*LCD_WIDTH);
+	uint32_t n = (y2 - y1 + 1)*LCD_WIDTH/4;
+	uint32_t dec = step * 0x01010101U, v;
+
+	DMA2D_waitBuffer(LCD_DRAW_BUFFER_WAVE);
+
+	while(n--){
+		v = __UQSUB8(*p, dec);
+		__USUB8(v, WAVE_IDX_RAMP * 0x01010101U);		/* GE set for the bytes still on the ramp */
+		*p++ = __SEL(v, 0);
+	}
 }
 
 /**
@@ -81,32 +438,25 @@ void fillScreenWave(UG_COLOR color)
   * @param  x2: x end
   * @param  y2: y end
   * @param  color: color to fill the frame with
-  * @retval None
+  * @retval UG_RESULT_FAIL if a DMA2D transfer has failed since the last report, UG_RESULT_OK otherwise
   */
 UG_RESULT fillFrameUGUI(UG_S16 x1, UG_S16 y1, UG_S16 x2, UG_S16 y2, UG_COLOR color)
 {
-	/* wait for any ongoing transfers to complete */
-	while(DMA2D->CR & 0x01);
-
-	DMA2D_error_flag = 0;					/* clear any existing error */
-
-	DMA2D->CR = 0x00030100;					/* reg-memory, transfer error intr enable */
-	DMA2D->OCOLR = color;					/* color */
+	DMA2DJob_t job = {0};
 
-	DMA2D->OMAR	= LCD_DRAW_BUFFER_UGUI +
-					2*(y1*LCD_WIDTH + x1);	/* output addr */
-	DMA2D->OOR = LCD_WIDTH - (x2 - x1 + 1); /* output offset */
-	DMA2D->OPFCCR = 0x02;					/* output format RGB565 */
-	DMA2D->NLR = (x2 - x1 + 1)<<16 |		/* frame dimensions */
-					(y2 - y1 + 1)<<0;
+	job.CR = 0x00032300;					/* reg-memory, transfer complete/error intr enable */
+	job.OCOLR = color;						/* color */
 
-	DMA2D->IFCR |= 0x3F;					/* clear all flags */
-	DMA2D->CR |= 0x01;						/* start transfer */
+	job.OMAR = LCD_DRAW_BUFFER_UGUI +
+				2*(y1*LCD_WIDTH + x1);		/* output addr */
+	job.OOR = LCD_WIDTH - (x2 - x1 + 1); 	/* output offset */
+	job.OPFCCR = 0x02;						/* output format RGB565 */
+	job.NLR = (x2 - x1 + 1)<<16 |			/* frame dimensions */
+				(y2 - y1 + 1)<<0;
 
-	/* wait for the transfer to complete */
-	while(DMA2D->CR & 0x01);
+	DMA2D_submit(&job);
 
-	return (DMA2D_error_flag ? UG_RESULT_FAIL : UG_RESULT_OK);
+	return (DMA2D_takeError() ? UG_RESULT_FAIL : UG_RESULT_OK);
 }
 
 /**
@@ -116,76 +466,287 @@ UG_RESULT fillFrameUGUI(UG_S16 x1, UG_S16 y1, UG_S16 x2, UG_S16 y2, UG_COLOR col
   * @param  x2: x end
   * @param  y2: y end
   * @param  color: color of the line
-  * @retval None
+  * @retval UG_RESULT_FAIL if the line is not horizontal/vertical or a DMA2D transfer has failed since
+  * 		the last report, UG_RESULT_OK otherwise
   */
 UG_RESULT drawLineUGUI(UG_S16 x1, UG_S16 y1, UG_S16 x2, UG_S16 y2, UG_COLOR color)
 {
-	/* wait for any ongoing transfers to complete */
-	while(DMA2D->CR & 0x01);
+	DMA2DJob_t job = {0};
 
-	DMA2D_error_flag = 0;					/* clear any existing error */
-
-	DMA2D->CR = 0x00030100;					/* reg-memory, transfer error intr enable */
-	DMA2D->OPFCCR = 0x02;					/* output format RGB565 */
-	DMA2D->OCOLR = color;					/* color */
-	DMA2D->OMAR	= LCD_DRAW_BUFFER_UGUI +
-					2*(y1*LCD_WIDTH + x1);	/* output addr */
+	job.CR = 0x00032300;					/* reg-memory, transfer complete/error intr enable */
+	job.OPFCCR = 0x02;						/* output format RGB565 */
+	job.OCOLR = color;						/* color */
+	job.OMAR = LCD_DRAW_BUFFER_UGUI +
+				2*(y1*LCD_WIDTH + x1);		/* output addr */
 
 	if(y1 == y2){
 		/* horizontal line */
-		DMA2D->OOR = 0; 					/* output offset */
-		DMA2D->NLR = (x2 - x1 + 1)<<16 |	/* frame dimensions */
-						(1)<<0;
+		job.OOR = 0; 						/* output offset */
+		job.NLR = (x2 - x1 + 1)<<16 |		/* frame dimensions */
+					(1)<<0;
 	}
 	else if(x1 == x2){
 		/* vertical line */
-		DMA2D->OOR = LCD_WIDTH - 1; 		/* output offset */
-		DMA2D->NLR = (1)<<16 |				/* frame dimensions */
-						(y2 - y1 + 1)<<0;
+		job.OOR = LCD_WIDTH - 1; 			/* output offset */
+		job.NLR = (1)<<16 |					/* frame dimensions */
+					(y2 - y1 + 1)<<0;
 	}
 	else{
 		return UG_RESULT_FAIL;
 	}
 
-	DMA2D->IFCR |= 0x3F;					/* clear all flags */
-	DMA2D->CR |= 0x01;						/* start transfer */
+	DMA2D_submit(&job);
+
+	return (DMA2D_takeError() ? UG_RESULT_FAIL : UG_RESULT_OK);
+}
+
+/**
+  * @brief  Blends a portion of an ARGB1555 overlay surface (same dimensions as the screen) over
+  * 		the same portion of the uGUI draw buffer. Transparent overlay pixels leave the draw
+  * 		buffer unchanged, opaque ones replace it.
+  * @param  src: overlay surface address
+  * @param  x1: x start
+  * @param  y1: y start
+  * @param  x2: x end
+  * @param  y2: y end
+  * @retval Fence of the queued job
+  */
+uint32_t overlayUGUI(uint32_t src, UG_S16 x1, UG_S16 y1, UG_S16 x2, UG_S16 y2)
+{
+	DMA2DJob_t job = {0};
+
+	job.CR = 0x00022300;					/* memory-memory with blending, transfer complete/error intr enable */
+
+	job.FGMAR = src + 2*(y1*LCD_WIDTH + x1);	/* foreground addr */
+	job.FGOR = LCD_WIDTH - (x2 - x1 + 1);	/* foreground offset */
+	job.FGPFCCR = 0x03;						/* foreground format ARGB1555 */
 
-	/* wait for the transfer to complete */
-	while(DMA2D->CR & 0x01);
+	job.BGMAR = LCD_DRAW_BUFFER_UGUI +
+				2*(y1*LCD_WIDTH + x1);		/* background addr */
+	job.BGOR = job.FGOR;					/* background offset */
+	job.BGPFCCR = 0x02;						/* background format RGB565 */
 
-	return (DMA2D_error_flag ? UG_RESULT_FAIL : UG_RESULT_OK);
+	job.OMAR = job.BGMAR;					/* output addr */
+	job.OOR = job.FGOR;						/* output offset */
+	job.OPFCCR = 0x02;						/* output format RGB565 */
+	job.NLR = (x2 - x1 + 1)<<16 |			/* frame dimensions */
+				(y2 - y1 + 1)<<0;
+
+	return DMA2D_submit(&job);
 }
 
 /**
-  * @brief  Blends the uGUI and Wave draw buffers and outputs to the frame buffer (screen).
+  * @brief  Renders the fonts used by the UI into the glyph atlas (one A8 byte per pixel,
+  * 		glyphs of a font stored back to back, char_width x char_height each).
+  * @param  None
+  * @retval None
+  */
+void initGlyphCache(void)
+{
+	const UG_FONT* fonts[GLYPH_CACHE_FONTS] = {&FONT_6X8, &FONT_7X12, &FONT_8X12};
+	uint8_t* pAtlas = (uint8_t *)GLYPH_ATLAS_BUFFER;
+	uint32_t n, ch, index, bn;
+	int32_t i, j, k, c;
+	uint8_t b;
+
+	for(n = 0; n < GLYPH_CACHE_FONTS; n++){
+		const UG_FONT* font = fonts[n];
+
+		glyphCache[n].p = font->p;
+		glyphCache[n].addr = (uint32_t)pAtlas;
+
+		bn = (font->char_width + 7) >> 3;		/* bytes per glyph row in the 1bpp font */
+		index = 0;
+
+		for(ch = font->start_char; ch <= font->end_char; ch++){
+			for(j = 0; j < font->char_height; j++){
+				c = font->char_width;
+				for(i = 0; i < bn; i++){
+					b = font->p[index++];
+					for(k = 0; k < 8 && c; k++, c--){
+						*pAtlas++ = (b & 0x01) ? 0xFF : 0x00;
+						b >>= 1;
+					}
+				}
+			}
+		}
+	}
+
+	nCachedFonts = GLYPH_CACHE_FONTS;
+}
+
+/**
+  * @brief  Draws a character from the glyph atlas into the uGUI draw buffer. The character
+  * 		cell is filled with the background color, then the A8 glyph is blended over it
+  * 		with the foreground color supplied by the DMA2D PFC.
+  * @param  chr: character code
+  * @param  x: x coordinate of the top left corner
+  * @param  y: y coordinate of the top left corner
+  * @param  fc: foreground (text) color
+  * @param  bc: background color
+  * @param  font: font of the character
+  * @retval UG_RESULT_FAIL if the font is not cached or the character is off-screen, UG_RESULT_OK otherwise
+  */
+UG_RESULT drawCharUGUI(UG_U8 chr, UG_S16 x, UG_S16 y, UG_COLOR fc, UG_COLOR bc, const UG_FONT* font)
+{
+	DMA2DJob_t job = {0};
+	uint32_t n;
+	UG_S16 w, h;
+
+	for(n = 0; n < nCachedFonts; n++){
+		if(glyphCache[n].p == font->p)
+			break;
+	}
+	if(n == nCachedFonts || font->font_type != FONT_TYPE_1BPP)
+		return UG_RESULT_FAIL;
+
+	w = font->widths ? font->widths[chr - font->start_char] : font->char_width;
+	h = font->char_height;
+	if(x < 0 || y < 0 || x + w > LCD_WIDTH || y + h > LCD_HEIGHT)
+		return UG_RESULT_FAIL;
+
+	fillFrameUGUI(x, y, x + w - 1, y + h - 1, bc);		/* character background */
+
+	job.CR = 0x00022300;							/* memory-memory with blending, transfer complete/error intr enable */
+
+	job.FGMAR = glyphCache[n].addr +				/* foreground addr (glyph) */
+				(chr - font->start_char)*font->char_width*h;
+	job.FGOR = font->char_width - w;				/* foreground offset */
+	job.FGPFCCR = 0x09;								/* foreground format A8 */
+	job.FGCOLR = rgb565to888(fc);					/* foreground color */
+
+	job.BGMAR = LCD_DRAW_BUFFER_UGUI +
+				2*(y*LCD_WIDTH + x);				/* background addr */
+	job.BGOR = LCD_WIDTH - w;						/* background offset */
+	job.BGPFCCR = 0x02;								/* background format RGB565 */
+
+	job.OMAR = job.BGMAR;							/* output addr */
+	job.OOR = job.BGOR;								/* output offset */
+	job.OPFCCR = 0x02;								/* output format RGB565 */
+	job.NLR = (w)<<16 |								/* frame dimensions */
+				(h)<<0;
+
+	DMA2D_submit(&job);
+
+	return UG_RESULT_OK;
+}
+
+/**
+  * @brief  Loads the Wave layer palette into the DMA2D background CLUT: fixed trace
+  * 		colors followed by an intensity ramp (black-blue-red-yellow-white).
   * @param  None
   * @retval None
   */
-void updateToScreen(void)
+void initWavePalette(void)
+{
+	uint32_t i, t, r, g, b;
+
+	for(i = 0; i < WAVE_IDX_RAMP; i++)
+		setWavePalette(i, C_BLACK);
+	setWavePalette(WAVE_IDX_CH1, CH1_COLOR);
+	setWavePalette(WAVE_IDX_CH2, CH2_COLOR);
+	setWavePalette(WAVE_IDX_MATH, MATH_COLOR);
+	setWavePalette(WAVE_IDX_FFT, FFT_COLOR);
+	setWavePalette(WAVE_IDX_ZOOMBOX, ZOOMBOX_COLOR);
+	setWavePalette(WAVE_IDX_SEPARATOR, CH_SEPARATOR_COLOR);
+	setWavePalette(WAVE_IDX_FFTMAX, FFTMAX_COLOR);
+	setWavePalette(WAVE_IDX_FFTMIN, FFTMIN_COLOR);
+	setWavePalette(WAVE_IDX_HARMONIC, HARMONIC_COLOR);
+
+	/* four segments of 32 levels each */
+	for(i = 0; i < WAVE_RAMP_LEVELS; i++){
+		t = (i & 0x1F) << 3;
+		switch(i >> 5){
+		case 0:  r = 0;   g = 0;   b = t;       break;		/* black to blue */
+		case 1:  r = t;   g = 0;   b = 255 - t; break;		/* blue to red */
+		case 2:  r = 255; g = t;   b = 0;       break;		/* red to yellow */
+		default: r = 255; g = 255; b = t;       break;		/* yellow to white */
+		}
+		DMA2D->BGCLUT[WAVE_IDX_RAMP + i] = 0xFF000000 | (r << 16) | (g << 8) | b;
+	}
+}
+
+/**
+  * @brief  Sets one entry of the Wave layer palette. Waits for the queued DMA2D jobs
+  * 		to finish, as the CLUT cannot be accessed while a transfer is running.
+  * @param  idx: palette index
+  * @param  color: RGB565 color of the entry
+  * @retval None
+  */
+void setWavePalette(uint8_t idx, UG_COLOR color)
 {
-	/* wait for any ongoing transfers to complete */
-	while(DMA2D->CR & 0x01);
+	DMA2D_waitIdle();
+
+	DMA2D->BGCLUT[idx] = 0xFF000000 | rgb565to888(color);		/* ARGB8888 entry */
+}
+
+/**
+  * @brief  Blends the uGUI and Wave draw buffers and outputs to the frame buffer (screen).
+  * @param  None
+  * @retval Fence of the queued job
+  */
+uint32_t updateToScreen(void)
+{
+	DMA2DJob_t job = {0};
+
+	job.CR = 0x00022300;						/* memory-memory with blending, transfer complete/error intr enable */
+
+	job.FGMAR = LCD_DRAW_BUFFER_UGUI;			/* foreground addr */
+	job.FGPFCCR = (0x02<<0) | 					/* foreground format RGB565 */
+				  (0x1<<16) |					/* replace original alpha */
+				  (UGUI_FRAME_ALPHA<<24);		/* blending alpha */
 
-	DMA2D->CR = 0x00020100;						/* memory-memory with blending, transfer error intr enable */
+	job.BGMAR = LCD_DRAW_BUFFER_WAVE;			/* background addr */
+	job.BGPFCCR = (0x05<<0) | 					/* background format L8 (CLUT loaded by initWavePalette) */
+				  (0x1<<16) |					/* replace original alpha */
+				  (WAVE_FRAME_ALPHA<<24);		/* blending alpha */
 
-	DMA2D->FGMAR = LCD_DRAW_BUFFER_UGUI;		/* foreground addr */
-	DMA2D->FGPFCCR = (0x02<<0) | 				/* foreground format RGB565 */
-					 (0x1<<16) |				/* replace original alpha */
-					 (UGUI_FRAME_ALPHA<<24);	/* blending alpha */
+	job.OMAR = LCD_FRAME_BUFFER;				/* output addr */
+	job.OOR = 0; 								/* output offset */
+	job.OPFCCR = 0x02;							/* output format RGB565 */
+	job.NLR = (LCD_WIDTH)<<16 |					/* frame dimensions */
+				(LCD_HEIGHT)<<0;
 
-	DMA2D->BGMAR = LCD_DRAW_BUFFER_WAVE;		/* background addr */
-	DMA2D->BGPFCCR = (0x02<<0) | 				/* background format RGB565 */
-					 (0x1<<16) |				/* replace original alpha */
-					 (WAVE_FRAME_ALPHA<<24);	/* blending alpha */
+	return DMA2D_submit(&job);
+}
 
-	DMA2D->OMAR	= LCD_FRAME_BUFFER;				/* output addr */
-	DMA2D->OOR = 0; 							/* output offset */
-	DMA2D->OPFCCR = 0x02;						/* output format RGB565 */
-	DMA2D->NLR = (LCD_WIDTH)<<16 |				/* frame dimensions */
-					(LCD_HEIGHT)<<0;
+/**
+  * @brief  Converts an RGB565 color to RGB888 (for the DMA2D color registers and CLUT).
+  * @param  color: RGB565 color
+  * @retval RGB888 color
+  */
+static uint32_t rgb565to888(UG_COLOR color)
+{
+	uint32_t r, g, b;
+
+	r = (color >> 11) & 0x1F;
+	g = (color >> 5) & 0x3F;
+	b = color & 0x1F;
+	r = (r << 3) | (r >> 2);
+	g = (g << 2) | (g >> 4);
+	b = (b << 3) | (b >> 2);
+
+	return (r << 16) | (g << 8) | b;
+}
 
-	DMA2D->IFCR |= 0x3F;						/* clear all flags */
-	DMA2D->CR |= 0x01;							/* start transfer */
+/**
+  * @brief  Plots one XY point: sets it to WAVE_IDX_CH1, or adds XY_PERSIST_HIT to its intensity.
+  * @param  p: pixel in the Wave draw buffer
+  * @param  persist: 1 to accumulate intensity
+  * @retval None
+  */
+static void plotXYPoint(__IO uint8_t* p, uint8_t persist)
+{
+	uint32_t v;
+
+	if(!persist){
+		*p = WAVE_IDX_CH1;
+		return;
+	}
 
-	while(DMA2D->CR & 0x01);
+	v = *p;
+	if(v < WAVE_IDX_RAMP)
+		*p = WAVE_IDX_RAMP + XY_PERSIST_HIT;
+	else
+		*p = min(v + XY_PERSIST_HIT, 255);
 }
@@ -15,6 +15,7 @@ __IO uint32_t Tick_1ms = 0;
 /* Array to store ADC readings */
 __IO uint8_t CH1_ADC_vals[ADC_BUF_SIZE];
 __IO uint8_t CH2_ADC_vals[ADC_BUF_SIZE];
+uint32_t acqSeq = 0;		/* sequence number of the last acquired frame */
 
 /* Field values in the top and bottom menubar. These index into the corresponding possible values array (except triglvl and offsets). */
 uint8_t vscale1 = VSCALE1_INITVAL;			/* Vertical scale of channel 1 */
@@ -57,15 +58,28 @@ __IO uint8_t DMA2D_error_flag = 0;
 /* Static mode related */
 uint8_t staticMode = 0;
 int32_t toffStm = TOFF_INITVAL;
-uint8_t vscale1Changed = 0, vscale2Changed = 0, voff1Changed = 0, voff2Changed = 0, toffChanged = 0;
+uint8_t vscale1Changed = 0, vscale2Changed = 0, voff1Changed = 0, voff2Changed = 0, toffChanged = 0, mathChanged = 0;
+uint8_t stmZoomView = 1;		/* overview + magnified view when zoomed in */
 
 uint8_t chDispMode = CHDISPMODE_SPLIT;
 
 uint8_t fftSrcChannel = CHANNELNONE;
+uint8_t fftView = FFTVIEW_SPECTRUM;
+uint8_t fftZoom = 0;			/* spectrum span is (fs/2)/2^fftZoom */
+float32_t fftCenter = 0.25f;	/* spectrum center frequency (fraction of fs) when zoomed */
+uint8_t fftWindow = FFTWIN_HANN;
+uint8_t fftAvg = 0;				/* spectrum power averaged over 2^fftAvg frames */
+uint8_t fftHold = 0;			/* FFTHOLD_xxx traces shown */
+uint8_t fftEngine = FFTENGINE_FLOAT;
+uint8_t fftPeaks = FFTPEAKS_OFF;
+uint8_t xyPersist = 0;		/* accumulate XY plots with decay */
+uint8_t xyLines = 0;		/* join the XY points with line segments */
 
 uint8_t mathOp = MATH_OP_NONE;
 uint8_t mathVscale = MATHVSCALE_INITVAL;
 int16_t mathVoff = MATHVOFF_INITVAL;
+uint8_t mathFn = MATH_FN_NONE;
+uint8_t mathFilt = MATH_FILT_OFF;
 
 uint8_t scrnshtViewMode = 0;
 
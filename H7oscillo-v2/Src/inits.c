@@ -23,6 +23,20 @@ void Timers_init(void)
 	TimTS_init();
 
 	TimMeas_init();
+
+	CycleCounter_init();
+}
+
+/**
+  * @brief  Enables the DWT cycle counter, used for timing the processing.
+  * @param  None
+  * @retval None
+  */
+void CycleCounter_init(void)
+{
+	CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+	DWT->CYCCNT = 0;
+	DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
 }
 
 /**
@@ -542,22 +556,14 @@ void DMA2D_init(void)
 	DMA2D->IFCR |= 0x3F;					/* clear all flags */
 	DMA2D->CR |= 0x01;						/* start transfer */
 
-	/* wait for the transfer to complete */
+	/* wait for the transfer to complete before the job queue takes over */
 	while(DMA2D->CR & 0x01);
 
-	DMA2D->CR = 0x00030100;					/* reg-memory, transfer error intr enable */
-	DMA2D->OCOLR = C_BLACK;					/* fill Wave draw buffer with black */
-
-	DMA2D->OMAR	= LCD_DRAW_BUFFER_WAVE;		/* output addr */
-	DMA2D->OPFCCR = 0x02;					/* output format RGB565 */
-	DMA2D->NLR = (RK043FN48H_WIDTH)<<16 |	/* frame dimensions */
-					(RK043FN48H_HEIGHT)<<0;
-
-	DMA2D->IFCR |= 0x3F;					/* clear all flags */
-	DMA2D->CR |= 0x01;						/* start transfer */
-
 	NVIC_SetPriority(DMA2D_IRQn, 2);
 	NVIC_EnableIRQ(DMA2D_IRQn);
+
+	/* clear the (L8) Wave draw buffer through the job queue, at its own size */
+	DMA2D_waitFence(fillScreenWave(WAVE_IDX_BG));
 }
 
 /**
@@ -22,11 +22,17 @@ int main(void)
 	uint32_t QE_Count = 0, QE_Count_prev = 1;
 	uint8_t QE_direc = 0;
 
-	__IO uint16_t (*pFrame)[LCD_WIDTH] = (__IO uint16_t (*)[LCD_WIDTH])LCD_DRAW_BUFFER_WAVE;
+	__IO uint8_t (*pFrame)[LCD_WIDTH] = (__IO uint8_t (*)[LCD_WIDTH])LCD_DRAW_BUFFER_WAVE;
 
-	int32_t trigPt = -1, waveIdxStart = 0, dispIdxStart = 0, lenResampledSig = -1;
+	int32_t trigPt = -1, waveIdxStart = 0, dispIdxStart = 0, lenResampledSig = -1, stmAnchor = 0;
+	uint8_t stmOvwValid = 0;		/* CHx_Env arrays hold the static mode overview */
+	uint32_t stmMathGen = 0;		/* math signal the static mode buffers were built from */
+	uint8_t stmMathOn = 0;			/* the static mode buffers include the math signal */
 	uint8_t origtscale = 0, oldtscale = 0;
-	int32_t	i, j, temp;
+	int32_t	i, j, k, temp;
+	uint32_t waveFence;
+	uint8_t wfallRunning = 0, xyPersistRunning = 0;
+	uint16_t xyColLUT[256], xyRowLUT[256];
 
 	/* Enable the CPU Cache */
 	CPU_CACHE_Enable();
@@ -47,6 +53,9 @@ int main(void)
 	/* clear the screen */
 	clearScreen();
 
+	/* load the Wave layer palette */
+	initWavePalette();
+
 	/* Initialize uGUI */
 	UG_Init(&gui, (void(*)(UG_S16,UG_S16,UG_COLOR))pset, LCD_WIDTH, LCD_HEIGHT);
 
@@ -55,6 +64,9 @@ int main(void)
 	UG_DriverEnable(DRIVER_FILL_FRAME);
 	UG_DriverRegister(DRIVER_DRAW_LINE, (void*)drawLineUGUI);
 	UG_DriverEnable(DRIVER_DRAW_LINE);
+	initGlyphCache();
+	UG_DriverRegister(DRIVER_DRAW_CHAR, (void*)drawCharUGUI);
+	UG_DriverEnable(DRIVER_DRAW_CHAR);
 
 	/* clear uGUI layer */
 	UG_FillScreen(C_BLACK);
@@ -125,9 +137,13 @@ int main(void)
 		/* check for trigger and display waveforms */
 		if(CH1_acq_comp && CH2_acq_comp){
 			CH1_acq_comp = CH2_acq_comp = 0;
+			acqSeq++;		/* results cached for the previous frame are stale */
 
 			trigPt = processTriggers();
 
+			/* math signal of the whole capture, for the trace, the spectrum, measurements and static mode */
+			calcMath((const uint8_t *)CH1_ADC_vals, (const uint8_t *)CH2_ADC_vals, ADC_BUF_SIZE);
+
 			/* trigger condition not met */
 			if(trigPt == -1 && runstopVals[runstop] != RUNSTOP_STOP){
 				UG_TextboxSetBackColor(&window_1, TXB_ID_6, RUNSTOP_ICON_COLOR_TRGWT);
@@ -138,8 +154,29 @@ int main(void)
 					(trigmodeVals[trigmode] == TRIGMODE_SNGL && trigPt != -1 && runstopVals[runstop] != RUNSTOP_STOP) ||
 					(trigmodeVals[trigmode] == TRIGMODE_NORM && trigPt != -1 && runstopVals[runstop] != RUNSTOP_STOP))
 			{
-				if(chDispMode != CHDISPMODE_FFT){
-					fillScreenWave(C_BLACK);	/* clear the wave draw buffer */
+				if(chDispMode != CHDISPMODE_FFT || fftView != FFTVIEW_WFALL)
+					wfallRunning = 0;		/* the waterfall restarts empty when shown again */
+				if(chDispMode != CHDISPMODE_XY || !xyPersist)
+					xyPersistRunning = 0;	/* as does the XY persistence */
+
+				/* Draw CH1 vs CH2 over the whole capture */
+				if(chDispMode == CHDISPMODE_XY){
+					if(xyPersistRunning)
+						decayWave(CHDISPMODE_MERGE_CHTOP, CHDISPMODE_MERGE_CHBOT, XY_PERSIST_DECAY);
+					else
+						fillScreenWave(WAVE_IDX_BG);	/* clear the wave draw buffer, drawXYWave() waits for it */
+					xyPersistRunning = xyPersist;
+
+					/* sample value to column/row tables, so that the plot loop is integer-only */
+					for(k = 0; k < 256; k++){
+						xyColLUT[k] = CHDISPMODE_XY_XSTART + CHDISPMODE_MERGE_CHBOT - sampleToRow(k, 1);
+						xyRowLUT[k] = sampleToRow(k, 2);
+					}
+
+					drawXYWave((uint8_t *)CH1_ADC_vals, (uint8_t *)CH2_ADC_vals, ADC_BUF_SIZE, xyColLUT, xyRowLUT, xyLines, xyPersist);
+				}
+				else if(chDispMode != CHDISPMODE_FFT){
+					waveFence = fillScreenWave(WAVE_IDX_BG);	/* clear the wave draw buffer */
 
 					origtscale = tscale;		/* store the original time scale of waveform */
 
@@ -156,6 +193,8 @@ int main(void)
 						dispIdxStart = 0;
 					}
 
+					DMA2D_waitFence(waveFence);		/* buffer must be cleared before drawing */
+
 					for(j = 0; j < LCD_WIDTH - waveIdxStart; j++){
 						/* CH1 */
 						temp = (float32_t)(voff1 + CH1_ADC_vals[waveIdxStart+j])/vscaleVals[vscale1];
@@ -171,7 +210,7 @@ int main(void)
 						else
 							i = CHDISPMODE_MERGE_CHBOT - temp;
 						if(dispIdxStart+j < LCD_WIDTH)
-							pFrame[i][dispIdxStart+j] = CH1_COLOR;
+							pFrame[i][dispIdxStart+j] = WAVE_IDX_CH1;
 
 						/* CH2 */
 						if(chDispMode != CHDISPMODE_SNGL){
@@ -188,47 +227,99 @@ int main(void)
 							else
 								i = CHDISPMODE_MERGE_CHBOT - temp;
 							if(dispIdxStart+j < LCD_WIDTH)
-								pFrame[i][dispIdxStart+j] = CH2_COLOR;
+								pFrame[i][dispIdxStart+j] = WAVE_IDX_CH2;
 						}
 
 						/* Math waveform */
 						if(mathOp != MATH_OP_NONE){
-							if(mathOp == MATH_OP_1P2)
-								temp = (mathVoff + 0.5f*((float32_t)CH1_ADC_vals[waveIdxStart+j] + CH2_ADC_vals[waveIdxStart+j]))/vscaleVals[mathVscale];
-							else if(mathOp == MATH_OP_1M2)
-								temp = (mathVoff + (float32_t)CH1_ADC_vals[waveIdxStart+j] - CH2_ADC_vals[waveIdxStart+j])/vscaleVals[mathVscale];
-							else if(mathOp == MATH_OP_2M1)
-								temp = (mathVoff + (float32_t)CH2_ADC_vals[waveIdxStart+j] - CH1_ADC_vals[waveIdxStart+j])/vscaleVals[mathVscale];
-							else
-								temp = (mathVoff + ((float32_t)CH1_ADC_vals[waveIdxStart+j]*CH2_ADC_vals[waveIdxStart+j])/256.0f)/vscaleVals[mathVscale];
-
-							if(temp > CHDISPMODE_MERGE_SIGMAX)	temp = CHDISPMODE_MERGE_SIGMAX;
-							if(temp < 0)  temp = 0;
-							i = CHDISPMODE_MERGE_CHBOT - temp;
+							i = sampleToRowArea(MATH_vals[waveIdxStart+j], CHANNELMATH, CHDISPMODE_MERGE_CHBOT, CHDISPMODE_MERGE_SIGMAX);
 							if(dispIdxStart+j < LCD_WIDTH)
-								pFrame[i][dispIdxStart+j] = MATH_COLOR;
+								pFrame[i][dispIdxStart+j] = WAVE_IDX_MATH;
+						}
+					}
+				}
+				/* Draw spectrogram, newest rows at the top */
+				else if(fftView == FFTVIEW_WFALL){
+					if(measPending){
+						if(!wfallRunning){
+							fillScreenWave(WAVE_IDX_BG);	/* start from an empty waterfall */
+							wfallRunning = 1;
+						}
+
+						/* scroll the existing image down, one new row per window position */
+						waveFence = scrollDownWave(CHDISPMODE_MERGE_CHTOP, CHDISPMODE_MERGE_CHBOT, WFALL_ROWS_PER_CAPTURE);
+
+						/* windows slide over the whole capture, oldest first */
+						for(k = 0; k < WFALL_ROWS_PER_CAPTURE; k++){
+							calcSpectrum(fftSrcChannel, k*WFALL_WINDOW_HOP, ADC_TRIGBUF_SIZE, 0);	/* the first one runs while the image is being scrolled */
+							DMA2D_waitFence(waveFence);
+
+							i = CHDISPMODE_MERGE_CHTOP + WFALL_ROWS_PER_CAPTURE - 1 - k;
+							for(j = 0; j < LCD_WIDTH; j++){
+								temp = chSpectrum[j];
+								if(temp > CHDISPMODE_MERGE_SIGMAX)	temp = CHDISPMODE_MERGE_SIGMAX;
+								if(temp < 0)  temp = 0;
+
+								pFrame[i][j] = WAVE_IDX_RAMP + temp*WAVE_RAMP_LEVELS/(CHDISPMODE_MERGE_SIGMAX + 1);
+							}
 						}
 					}
 				}
 				/* Draw spectrum */
 				else{
 					if(measPending){
-						fillScreenWave(C_BLACK);			/* clear the wave draw buffer */
+						waveFence = fillScreenWave(WAVE_IDX_BG);	/* clear the wave draw buffer */
 
-						calcSpectrum(fftSrcChannel);
+						calcSpectrum(fftSrcChannel, 0, fftZoom ? ADC_BUF_SIZE : ADC_TRIGBUF_SIZE, 1);	/* runs while the buffer is being cleared, whole capture when zoomed */
+						DMA2D_waitFence(waveFence);
 
 						for(j = 0; j < LCD_WIDTH; j++){
 							temp = chSpectrum[j];
 							if(temp > CHDISPMODE_MERGE_SIGMAX)	temp = CHDISPMODE_MERGE_SIGMAX;
 
-							for(int32_t k = 0; k <= temp; k++){
-								i = CHDISPMODE_MERGE_CHBOT - k;
-								pFrame[i][j] = FFT_COLOR;
+							if(temp >= 0)
+								drawSpanWave(j, CHDISPMODE_MERGE_CHBOT - temp, CHDISPMODE_MERGE_CHBOT, WAVE_IDX_FFT);
+						}
+
+						/* max/min hold traces, each column joined to the previous one */
+						for(k = FFTHOLD_MAX; k <= FFTHOLD_MIN; k <<= 1){
+							if(!(fftHold & k))
+								continue;
+
+							for(j = 0; j < LCD_WIDTH; j++){
+								temp = (k == FFTHOLD_MAX) ? chSpectrumMax[j] : chSpectrumMin[j];
+								if(temp > CHDISPMODE_MERGE_SIGMAX)	temp = CHDISPMODE_MERGE_SIGMAX;
+								temp = CHDISPMODE_MERGE_CHBOT - temp;
+								if(j == 0)	i = temp;
+
+								drawSpanWave(j, min(i, temp), max(i, temp), (k == FFTHOLD_MAX) ? WAVE_IDX_FFTMAX : WAVE_IDX_FFTMIN);
+								i = temp;
+							}
+						}
+
+						/* dashed harmonic markers at the multiples of the strongest peak */
+						if(fftPeaks == FFTPEAKS_HARM && spectrumPeakCnt > 0){
+							for(k = 2; k <= FFT_HARM_MARKERS; k++){
+								temp = spectrumBin(k*spectrumPeaks[0].freq) + 0.5f;
+								if(temp >= LCD_WIDTH)
+									break;
+								if(temp < 0)
+									continue;
+
+								for(i = CHDISPMODE_MERGE_CHTOP; i < CHDISPMODE_MERGE_CHBOT; i += 6)
+									drawSpanWave(temp, i, i + 2, WAVE_IDX_HARMONIC);
 							}
 						}
 					}
 				}
 
+				/* screen column c shows captured sample c + waveIdxStart - dispIdxStart */
+				setMeasView((const uint8_t *)CH1_ADC_vals, (const uint8_t *)CH2_ADC_vals, MATH_vals, ADC_BUF_SIZE, waveIdxStart - dispIdxStart, 1, samprateVals[tscale], samprateVals[tscale]);
+
+				/* measurement statistics are updated on every displayed acquisition */
+				if(measStatsOn)
+					accumulateMeasurements();
+
 				/* go to STOP mode after a single mode trigger event */
 				if(trigmodeVals[trigmode] == TRIGMODE_SNGL){
 					trigPt = -1;
@@ -240,6 +331,9 @@ int main(void)
 				}
 			}
 
+			/* measure this frame before the buffers get refilled */
+			calcMeasurements();
+
 			/* capture next waveform frame */
 			if((trigmodeVals[trigmode] != TRIGMODE_SNGL || trigPt == -1) && runstopVals[runstop] != RUNSTOP_STOP){
 				ADC_Ch1_reinit();
@@ -256,12 +350,18 @@ int main(void)
 				/* a touch to the center of the screen starts static mode */
 				if(TS_DetectNumTouches() > 0){
 					TS_GetXY(&TS_Y, &TS_X);
-					if(chDispMode != CHDISPMODE_FFT && mathOp == MATH_OP_NONE && 215 < TS_X && TS_X < 265 && 111 < TS_Y && TS_Y < 161){
+					if(chDispMode != CHDISPMODE_FFT && chDispMode != CHDISPMODE_XY && 215 < TS_X && TS_X < 265 && 111 < TS_Y && TS_Y < 161){
 						staticMode = 1;
 						oldtscale = origtscale;
 						toffStm = toff;
+						stmAnchor = waveIdxStart - dispIdxStart + toff;	/* captured sample under the toff cursor */
 						drawRedBorder();					/* to indicate static mode */
+						calcMath((const uint8_t *)CH1_ADC_vals, (const uint8_t *)CH2_ADC_vals, ADC_BUF_SIZE);
 						lenResampledSig = resampleChannels(waveIdxStart, LCD_WIDTH - abs(dispIdxStart - waveIdxStart), origtscale, origtscale);
+						buildMinMaxPyramid();				/* for zoomed-out views of the whole capture */
+						stmOvwValid = 0;
+						stmMathGen = mathGen;
+						stmMathOn = (mathOp != MATH_OP_NONE);
 						while(TS_DetectNumTouches() > 0);	/* wait for touch to be removed */
 					}
 				}
@@ -283,8 +383,31 @@ int main(void)
 			}
 
 			if(staticMode){
+				/* math settings changed, recompute the math signal of the capture and its resampled
+				   signal and min/max pyramid, which are only built while math is on */
+				if(mathChanged){
+					calcMath((const uint8_t *)CH1_ADC_vals, (const uint8_t *)CH2_ADC_vals, ADC_BUF_SIZE);
+					if(mathOp == MATH_OP_NONE){
+						stmMathOn = 0;			/* resampling skips math from now on, rebuild when it is back on */
+					}
+					else if(mathGen != stmMathGen || !stmMathOn){
+						stmMathGen = mathGen;
+						stmMathOn = 1;
+						if(tscale <= origtscale)
+							resampleChannels(waveIdxStart, LCD_WIDTH - abs(dispIdxStart - waveIdxStart), origtscale, tscale);
+						buildMinMaxPyramid();
+						stmOvwValid = 0;
+					}
+				}
+
+				/* sample frequency changed, zoom out from the min/max pyramid */
+				if(tscale != oldtscale && tscale > origtscale){
+					oldtscale = tscale;
+					toffStm = toff;
+					redrawWf = 1;
+				}
 				/* sample frequency changed, resample the captured waveform */
-				if(tscale != oldtscale){
+				else if(tscale != oldtscale){
 					lenResampledSig = resampleChannels(waveIdxStart, LCD_WIDTH - abs(dispIdxStart - waveIdxStart), origtscale, tscale);
 
 					/* given samplerate conversion not possible, revert tscale */
@@ -303,48 +426,120 @@ int main(void)
 					}
 				}
 				else if(vscale1Changed || vscale2Changed || voff1Changed
-						|| voff2Changed || toffChanged){
+						|| voff2Changed || toffChanged || mathChanged){
 					drawRedBorder();		/* since it would have got erased due to moving cursors */
 					redrawWf = 1;
 				}
 
 				if(redrawWf){
-					int32_t trigPtStm, waveIdxStartStm, dispIdxStartStm;
-
-					trigPtStm = chkTrigResampSig(lenResampledSig);
+					/* zoomed out, draw the min/max envelope of the whole capture as vertical spans */
+					if(tscale > origtscale){
+						float32_t spc = (float32_t)samprateVals[origtscale]/samprateVals[tscale];	/* samples per column */
 
-					waveIdxStartStm = max(0, min(trigPtStm - toffStm, lenResampledSig - 1));
-					dispIdxStartStm = max(0, min(toffStm - trigPtStm, LCD_WIDTH - 1));
+						/* limit toffStm value so that waveform doesn't go out of screen */
+						toffStm = max(toffStm, (int32_t)((stmAnchor - (ADC_BUF_SIZE))/spc) + 1);
+						toffStm = min(toffStm, (int32_t)(stmAnchor/spc) + LCD_WIDTH - 1);
 
-					/* limit toffStm value so that waveform doesn't go out of screen */
-					if(trigPtStm - toffStm > lenResampledSig - 1)
-						toffStm = trigPtStm - lenResampledSig + 1;
-					else if(toffStm - trigPtStm > LCD_WIDTH - 1)
-						toffStm = trigPtStm + LCD_WIDTH - 1;
+						envelopeChannels(stmAnchor - toffStm*spc, spc);
+						stmOvwValid = 0;
+						setMeasView((const uint8_t *)CH1_ADC_vals, (const uint8_t *)CH2_ADC_vals, MATH_vals, ADC_BUF_SIZE, stmAnchor - toffStm*spc, spc, samprateVals[origtscale], samprateVals[origtscale]);
 
-					fillScreenWave(C_BLACK);				/* clear the wave draw buffer */
+						waveFence = fillScreenWave(WAVE_IDX_BG);	/* clear the wave draw buffer */
+						DMA2D_waitFence(waveFence);
 
-					/* Draw the resampled signal */
-					for(j = 0; j < LCD_WIDTH && waveIdxStartStm+j < lenResampledSig; j++){
-						/* CH1 */
-						temp = (float32_t)(voff1 + CH1_ResampledVals[waveIdxStartStm+j])/vscaleVals[vscale1];
 						if(chDispMode == CHDISPMODE_SPLIT){
-							if(temp > CHDISPMODE_SPLIT_SIGMAX)	temp = CHDISPMODE_SPLIT_SIGMAX;
+							drawEnvelopeWave(CH1_EnvMin, CH1_EnvMax, 1, CHDISPMODE_SPLIT_CH1BOT, CHDISPMODE_SPLIT_SIGMAX, WAVE_IDX_CH1);
+							drawEnvelopeWave(CH2_EnvMin, CH2_EnvMax, 2, CHDISPMODE_SPLIT_CH2BOT, CHDISPMODE_SPLIT_SIGMAX, WAVE_IDX_CH2);
 						}
 						else{
-							if(temp > CHDISPMODE_MERGE_SIGMAX)	temp = CHDISPMODE_MERGE_SIGMAX;
+							drawEnvelopeWave(CH1_EnvMin, CH1_EnvMax, 1, CHDISPMODE_MERGE_CHBOT, CHDISPMODE_MERGE_SIGMAX, WAVE_IDX_CH1);
+							if(chDispMode != CHDISPMODE_SNGL)
+								drawEnvelopeWave(CH2_EnvMin, CH2_EnvMax, 2, CHDISPMODE_MERGE_CHBOT, CHDISPMODE_MERGE_SIGMAX, WAVE_IDX_CH2);
+						}
+						if(mathOp != MATH_OP_NONE)
+							drawEnvelopeWave(MATH_EnvMin, MATH_EnvMax, CHANNELMATH, CHDISPMODE_MERGE_CHBOT, CHDISPMODE_MERGE_SIGMAX, WAVE_IDX_MATH);
+					}
+					/* zoomed in with the zoom view on: overview of the whole capture on top with the
+					   magnified region boxed, magnified region below the separator */
+					else if(stmZoomView && tscale < origtscale){
+						int32_t trigPtStm, waveIdxStartStm, dispIdxStartStm, x1, x2;
+						float32_t spc = (float32_t)(ADC_BUF_SIZE)/LCD_WIDTH;		/* overview samples per column */
+						float32_t r = (float32_t)lenResampledSig/(LCD_WIDTH - abs(dispIdxStart - waveIdxStart));	/* magnification */
+
+						trigPtStm = chkTrigResampSig(lenResampledSig);
+
+						/* limit toffStm value so that waveform doesn't go out of screen */
+						if(trigPtStm - toffStm > lenResampledSig - 1)
+							toffStm = trigPtStm - lenResampledSig + 1;
+						else if(toffStm - trigPtStm > LCD_WIDTH - 1)
+							toffStm = trigPtStm + LCD_WIDTH - 1;
+
+						waveIdxStartStm = max(0, min(trigPtStm - toffStm, lenResampledSig - 1));
+						dispIdxStartStm = max(0, min(toffStm - trigPtStm, LCD_WIDTH - 1));
+						setMeasView(CH1_ResampledVals, CH2_ResampledVals, MATH_ResampledVals, lenResampledSig, waveIdxStartStm - dispIdxStartStm, 1, samprateVals[tscale], samprateVals[origtscale]);
+
+						/* the overview envelope only changes with the capture, panning just moves the box */
+						if(!stmOvwValid){
+							envelopeChannels(0, spc);
+							stmOvwValid = 1;
 						}
-						if(temp < 0)  temp = 0;
-						if(chDispMode == CHDISPMODE_SPLIT)
-							i = CHDISPMODE_SPLIT_CH1BOT - temp;
-						else
-							i = CHDISPMODE_MERGE_CHBOT - temp;
-						if(dispIdxStartStm+j < LCD_WIDTH)
-							pFrame[i][dispIdxStartStm+j] = CH1_COLOR;
 
-						/* CH2 */
-						if(chDispMode != CHDISPMODE_SNGL){
-							temp = (float32_t)(voff2 + CH2_ResampledVals[waveIdxStartStm+j])/vscaleVals[vscale2];
+						waveFence = fillScreenWave(WAVE_IDX_BG);	/* clear the wave draw buffer */
+						DMA2D_waitFence(waveFence);
+
+						/* zoom box, behind the overview traces */
+						x1 = (waveIdxStart + (waveIdxStartStm - dispIdxStartStm)/r)/spc;
+						x2 = x1 + LCD_WIDTH/(r*spc);
+						x1 = max(0, min(x1, LCD_WIDTH - 1));
+						x2 = max(x1, min(x2, LCD_WIDTH - 1));
+						fillRectWave(x1, CHDISPMODE_SPLIT_CH1TOP, x2, CHDISPMODE_SPLIT_CH1BOT, WAVE_IDX_ZOOMBOX);
+						fillRectWave(0, CH_SEPARATOR_POS, LCD_WIDTH - 1, CH_SEPARATOR_POS, WAVE_IDX_SEPARATOR);
+
+						drawEnvelopeWave(CH1_EnvMin, CH1_EnvMax, 1, CHDISPMODE_SPLIT_CH1BOT, CHDISPMODE_SPLIT_SIGMAX, WAVE_IDX_CH1);
+						if(chDispMode != CHDISPMODE_SNGL)
+							drawEnvelopeWave(CH2_EnvMin, CH2_EnvMax, 2, CHDISPMODE_SPLIT_CH1BOT, CHDISPMODE_SPLIT_SIGMAX, WAVE_IDX_CH2);
+						if(mathOp != MATH_OP_NONE)
+							drawEnvelopeWave(MATH_EnvMin, MATH_EnvMax, CHANNELMATH, CHDISPMODE_SPLIT_CH1BOT, CHDISPMODE_SPLIT_SIGMAX, WAVE_IDX_MATH);
+
+						/* magnified region */
+						for(j = 0; j < LCD_WIDTH && waveIdxStartStm+j < lenResampledSig && dispIdxStartStm+j < LCD_WIDTH; j++){
+							i = sampleToRowArea(CH1_ResampledVals[waveIdxStartStm+j], 1, CHDISPMODE_SPLIT_CH2BOT, CHDISPMODE_SPLIT_SIGMAX);
+							pFrame[i][dispIdxStartStm+j] = WAVE_IDX_CH1;
+
+							if(chDispMode != CHDISPMODE_SNGL){
+								i = sampleToRowArea(CH2_ResampledVals[waveIdxStartStm+j], 2, CHDISPMODE_SPLIT_CH2BOT, CHDISPMODE_SPLIT_SIGMAX);
+								pFrame[i][dispIdxStartStm+j] = WAVE_IDX_CH2;
+							}
+
+							if(mathOp != MATH_OP_NONE){
+								i = sampleToRowArea(MATH_ResampledVals[waveIdxStartStm+j], CHANNELMATH, CHDISPMODE_SPLIT_CH2BOT, CHDISPMODE_SPLIT_SIGMAX);
+								pFrame[i][dispIdxStartStm+j] = WAVE_IDX_MATH;
+							}
+						}
+					}
+					else{
+						int32_t trigPtStm, waveIdxStartStm, dispIdxStartStm;
+
+						trigPtStm = chkTrigResampSig(lenResampledSig);
+
+						waveIdxStartStm = max(0, min(trigPtStm - toffStm, lenResampledSig - 1));
+						dispIdxStartStm = max(0, min(toffStm - trigPtStm, LCD_WIDTH - 1));
+
+						/* limit toffStm value so that waveform doesn't go out of screen */
+						if(trigPtStm - toffStm > lenResampledSig - 1)
+							toffStm = trigPtStm - lenResampledSig + 1;
+						else if(toffStm - trigPtStm > LCD_WIDTH - 1)
+							toffStm = trigPtStm + LCD_WIDTH - 1;
+
+						setMeasView(CH1_ResampledVals, CH2_ResampledVals, MATH_ResampledVals, lenResampledSig, waveIdxStartStm - dispIdxStartStm, 1, samprateVals[tscale], samprateVals[origtscale]);
+
+						waveFence = fillScreenWave(WAVE_IDX_BG);	/* clear the wave draw buffer */
+						DMA2D_waitFence(waveFence);
+
+						/* Draw the resampled signal */
+						for(j = 0; j < LCD_WIDTH && waveIdxStartStm+j < lenResampledSig; j++){
+							/* CH1 */
+							temp = (float32_t)(voff1 + CH1_ResampledVals[waveIdxStartStm+j])/vscaleVals[vscale1];
 							if(chDispMode == CHDISPMODE_SPLIT){
 								if(temp > CHDISPMODE_SPLIT_SIGMAX)	temp = CHDISPMODE_SPLIT_SIGMAX;
 							}
@@ -353,15 +548,40 @@ int main(void)
 							}
 							if(temp < 0)  temp = 0;
 							if(chDispMode == CHDISPMODE_SPLIT)
-								i = CHDISPMODE_SPLIT_CH2BOT - temp;
+								i = CHDISPMODE_SPLIT_CH1BOT - temp;
 							else
 								i = CHDISPMODE_MERGE_CHBOT - temp;
 							if(dispIdxStartStm+j < LCD_WIDTH)
-								pFrame[i][dispIdxStartStm+j] = CH2_COLOR;
+								pFrame[i][dispIdxStartStm+j] = WAVE_IDX_CH1;
+
+							/* CH2 */
+							if(chDispMode != CHDISPMODE_SNGL){
+								temp = (float32_t)(voff2 + CH2_ResampledVals[waveIdxStartStm+j])/vscaleVals[vscale2];
+								if(chDispMode == CHDISPMODE_SPLIT){
+									if(temp > CHDISPMODE_SPLIT_SIGMAX)	temp = CHDISPMODE_SPLIT_SIGMAX;
+								}
+								else{
+									if(temp > CHDISPMODE_MERGE_SIGMAX)	temp = CHDISPMODE_MERGE_SIGMAX;
+								}
+								if(temp < 0)  temp = 0;
+								if(chDispMode == CHDISPMODE_SPLIT)
+									i = CHDISPMODE_SPLIT_CH2BOT - temp;
+								else
+									i = CHDISPMODE_MERGE_CHBOT - temp;
+								if(dispIdxStartStm+j < LCD_WIDTH)
+									pFrame[i][dispIdxStartStm+j] = WAVE_IDX_CH2;
+							}
+
+							/* Math */
+							if(mathOp != MATH_OP_NONE){
+								i = sampleToRowArea(MATH_ResampledVals[waveIdxStartStm+j], CHANNELMATH, CHDISPMODE_MERGE_CHBOT, CHDISPMODE_MERGE_SIGMAX);
+								if(dispIdxStartStm+j < LCD_WIDTH)
+									pFrame[i][dispIdxStartStm+j] = WAVE_IDX_MATH;
+							}
 						}
 					}
 
-					vscale1Changed = vscale2Changed = voff1Changed = voff2Changed = toffChanged = 0;
+					vscale1Changed = vscale2Changed = voff1Changed = voff2Changed = toffChanged = mathChanged = 0;
 					redrawWf = 0;
 				}
 			}
@@ -426,9 +646,6 @@ int main(void)
 				}
 			}
 
-			/* uGUI can show only one window at a time. Switch between them to display multiple at the same time. */
-			switchNextWindow();
-
 			TS_read_pending = 0;
 		}
 
@@ -459,7 +676,8 @@ int main(void)
 			QE_Count_prev = QE_Count;
 		}
 
-		UG_Update();
+		/* Redraw the changed parts of all the visible windows */
+		updateWindows();
 
 		/* Update screen */
 		if(!scrnshtViewMode){
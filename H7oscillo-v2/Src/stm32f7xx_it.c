@@ -200,16 +200,20 @@ void LTDC_ER_IRQHandler(void)
 }
 
 /**
-  * @brief  This function handles DMA2D transfer error.
+  * @brief  This function handles DMA2D transfer complete/error.
   * @param  None
   * @retval None
   */
 void DMA2D_IRQHandler(void)
 {
-	DMA2D->CR &= ~0x0100;		/* disable transfer interrupts */
+	if(DMA2D->ISR & 0x21){		/* transfer or configuration error */
+		DMA2D_error_flag = 1;
+	}
+
 	DMA2D->IFCR |= 0x3F;		/* clear all flags */
 
-	DMA2D_error_flag = 1;
+	/* the failed/finished job is retired, start the next queued job */
+	DMA2D_processQueue();
 }
 
 /**
@@ -220,10 +220,34 @@ static const float32_t firlp23[253] = {
 /* Resampled channel signals */
 uint8_t CH1_ResampledVals[MAX_RESAMPLEDSIG_LEN];
 uint8_t CH2_ResampledVals[MAX_RESAMPLEDSIG_LEN];
+uint8_t MATH_ResampledVals[MAX_RESAMPLEDSIG_LEN];
+
+/* Per-column min/max envelopes of the channel signals */
+uint8_t CH1_EnvMin[MAX_ENVELOPE_LEN], CH1_EnvMax[MAX_ENVELOPE_LEN];
+uint8_t CH2_EnvMin[MAX_ENVELOPE_LEN], CH2_EnvMax[MAX_ENVELOPE_LEN];
+uint8_t MATH_EnvMin[MAX_ENVELOPE_LEN], MATH_EnvMax[MAX_ENVELOPE_LEN];
+
+/* Min/max pyramid of the captured channel signals and the math signal. Level l (1 to MINMAX_PYR_LEVELS)
+   holds the min/max of blocks of 2^(l+1) samples, starting at pyrOffset[l]; level 0 is the signal itself. */
+static uint8_t pyrMin[3][MINMAX_PYR_SIZE], pyrMax[3][MINMAX_PYR_SIZE];
+static uint32_t pyrOffset[MINMAX_PYR_LEVELS + 1];
+
+/* Math signal of the capture, 8-bit samples of MATH_LSB codes with the zero at MATH_ZERO, saturated */
+uint8_t MATH_vals[ADC_BUF_SIZE];
+uint32_t mathGen;								/* changes whenever MATH_vals does */
+static float32_t mathVals[ADC_BUF_SIZE];		/* math waveform in ADC codes, when filtered or a function is applied */
+static float32_t mathTmp[ADC_BUF_SIZE + MATH_FIR_DELAY];	/* second operand, filter output */
+static float32_t mathFirCoeffs[MATH_FIR_TAPS];
+static float32_t mathFirState[MATH_FIR_TAPS + MATH_FIR_BLOCK - 1];
+static uint8_t mathFirFilt = MATH_FILT_OFF;		/* cutoff of mathFirCoeffs */
 
 static int32_t calcFilters(uint8_t origSR, uint8_t newSR, Filter* filt1ptr, Filter* filt2ptr, Filter* filt3ptr);
 static int32_t findNextMultiple(int32_t n, int32_t q);
 static uint32_t getFiltDelay(uint8_t fact);
+static void minMaxU8(const uint8_t* x, uint32_t len, uint8_t* pmin, uint8_t* pmax);
+static void u8ToFloat(const uint8_t* x, float32_t* y, uint32_t len);
+static void mathOpU8(const uint8_t* x1, const uint8_t* x2, uint8_t* y, uint32_t len);
+static void genMathFir(uint8_t filt);
 
 /**
   * @brief  Processes input waveform for trigger.
@@ -302,7 +326,8 @@ int32_t chkTrigResampSig(int32_t len)
 }
 
 /**
-  * @brief  Resample both the channel signals of length lenx of samplerate index origSR to new samplerate newSR.
+  * @brief  Resample both the channel signals (and the math signal, when on) of length lenx of samplerate
+  * 		index origSR to new samplerate newSR.
   * @param  offset: Signal's sample offset in ADC buffer
   * @param  lenx: length of x
   * @param  origSR: Index of the sample rate of x
@@ -321,6 +346,7 @@ int32_t resampleChannels(uint32_t offset, uint32_t lenx, uint8_t origSR, uint8_t
 		for(i = 0; i < lenx; i++){
 			CH1_ResampledVals[i] = CH1_ADC_vals[offset + i];
 			CH2_ResampledVals[i] = CH2_ADC_vals[offset + i];
+			MATH_ResampledVals[i] = MATH_vals[offset + i];
 		}
 
 		return lenx;
@@ -338,15 +364,19 @@ int32_t resampleChannels(uint32_t offset, uint32_t lenx, uint8_t origSR, uint8_t
 	uint32_t prevStageOupLen, prevStageOupOffset;
 
 	/* iterate for each channel */
-	for(ch = 0; ch < 2; ch++){
+	for(ch = 0; ch < ((mathOp != MATH_OP_NONE) ? 3 : 2); ch++){
 		if(ch == 0){
 			x = (uint8_t *)CH1_ADC_vals + offset;
 			CHx_ResampledVals = CH1_ResampledVals;
 		}
-		else{
+		else if(ch == 1){
 			x = (uint8_t *)CH2_ADC_vals + offset;
 			CHx_ResampledVals = CH2_ResampledVals;
 		}
+		else{
+			x = MATH_vals + offset;
+			CHx_ResampledVals = MATH_ResampledVals;
+		}
 
 		/* Filter 1 */
 		if(filt1.type == FILTERTYPE_INT){
@@ -498,6 +528,143 @@ int32_t resampleChannels(uint32_t offset, uint32_t lenx, uint8_t origSR, uint8_t
 	return prevStageOupLen;
 }
 
+/**
+  * @brief  Build the min/max pyramid of both the captured channel signals and the math signal (whole ADC buffer).
+  * 		Called once per capture, zoomed-out views are then answered by queryMinMax().
+  * @param  None
+  * @retval None
+  */
+void buildMinMaxPyramid(void)
+{
+	uint8_t *x, *mn, *mx;
+	uint32_t ch, l, i, n;
+
+	pyrOffset[1] = 0;
+	for(l = 2; l <= MINMAX_PYR_LEVELS; l++)
+		pyrOffset[l] = pyrOffset[l-1] + ((ADC_BUF_SIZE) >> l);
+
+	for(ch = 0; ch < ((mathOp != MATH_OP_NONE) ? 3 : 2); ch++){
+		x = (ch == 0) ? (uint8_t *)CH1_ADC_vals : ((ch == 1) ? (uint8_t *)CH2_ADC_vals : MATH_vals);
+		mn = pyrMin[ch];
+		mx = pyrMax[ch];
+
+		/* level 1 from the signal, blocks of 4 samples */
+		n = (ADC_BUF_SIZE) >> 2;
+		decimateMinMax(x, n << 2, mn, mx, n);
+
+		/* each further level from pairs of blocks of the previous level */
+		for(l = 2; l <= MINMAX_PYR_LEVELS; l++){
+			n = (ADC_BUF_SIZE) >> (l + 1);
+			for(i = 0; i < n; i++){
+				mn[pyrOffset[l] + i] = min(mn[pyrOffset[l-1] + 2*i], mn[pyrOffset[l-1] + 2*i + 1]);
+				mx[pyrOffset[l] + i] = max(mx[pyrOffset[l-1] + 2*i], mx[pyrOffset[l-1] + 2*i + 1]);
+			}
+		}
+	}
+}
+
+/**
+  * @brief  Find the min and max of a captured channel signal over the samples [start, end), using
+  * 		the largest aligned pyramid blocks that fit (O(log(end - start)) block reads).
+  * @param  ch: channel (1 or 2, 3 for math)
+  * @param  start: first sample, index into the ADC buffer
+  * @param  end: one past the last sample, must be > start
+  * @param  pmin: min value
+  * @param  pmax: max value
+  * @retval None
+  */
+void queryMinMax(uint8_t ch, int32_t start, int32_t end, uint8_t* pmin, uint8_t* pmax)
+{
+	uint8_t *x, *mn, *mx;
+	uint8_t vmin = 0xFF, vmax = 0;
+	uint32_t l;
+
+	x = (ch == 1) ? (uint8_t *)CH1_ADC_vals : ((ch == 2) ? (uint8_t *)CH2_ADC_vals : MATH_vals);
+	mn = pyrMin[ch - 1];
+	mx = pyrMax[ch - 1];
+
+	while(start < end){
+		/* largest block aligned to start that ends within the range */
+		l = 0;
+		while(l < MINMAX_PYR_LEVELS && !(start & ((2 << (l + 1)) - 1)) && start + (2 << (l + 1)) <= end)
+			l++;
+
+		if(l == 0){
+			vmin = min(vmin, x[start]);
+			vmax = max(vmax, x[start]);
+			start++;
+		}
+		else{
+			vmin = min(vmin, mn[pyrOffset[l] + (start >> (l + 1))]);
+			vmax = max(vmax, mx[pyrOffset[l] + (start >> (l + 1))]);
+			start += 2 << l;
+		}
+	}
+
+	*pmin = vmin;
+	*pmax = vmax;
+}
+
+/**
+  * @brief  Compute the per-column min/max envelopes (CHx_EnvMin/CHx_EnvMax) of both the captured
+  * 		channel signals, and MATH_EnvMin/MATH_EnvMax when math is on, for a screen-wide window,
+  * 		from the min/max pyramid. Columns outside the captured signal are marked empty with min > max.
+  * @param  start: ADC buffer sample index at the left edge of the screen
+  * @param  spc: no. of samples per column (>= 1)
+  * @retval None
+  */
+void envelopeChannels(float32_t start, float32_t spc)
+{
+	int32_t c, s, e;
+
+	for(c = 0; c < MAX_ENVELOPE_LEN; c++){
+		s = floorf(start + c*spc);
+		e = floorf(start + (c + 1)*spc);
+		if(e <= s)
+			e = s + 1;
+		s = max(s, 0);
+		e = min(e, (ADC_BUF_SIZE));
+
+		if(s >= e){
+			CH1_EnvMin[c] = CH2_EnvMin[c] = MATH_EnvMin[c] = 0xFF;
+			CH1_EnvMax[c] = CH2_EnvMax[c] = MATH_EnvMax[c] = 0;
+			continue;
+		}
+
+		queryMinMax(1, s, e, &CH1_EnvMin[c], &CH1_EnvMax[c]);
+		queryMinMax(2, s, e, &CH2_EnvMin[c], &CH2_EnvMax[c]);
+		if(mathOp != MATH_OP_NONE)
+			queryMinMax(CHANNELMATH, s, e, &MATH_EnvMin[c], &MATH_EnvMax[c]);
+	}
+}
+
+/**
+  * @brief  Reduce signal x of length lenx to ncols min/max pairs. Column c covers the samples
+  * 		[c*lenx/ncols, (c+1)*lenx/ncols), so no sample is skipped for a non-integer ratio.
+  * @param  x: input signal
+  * @param  lenx: length of x
+  * @param  xmin: output array of column minimums
+  * @param  xmax: output array of column maximums
+  * @param  ncols: no. of columns
+  * @retval None
+  */
+void decimateMinMax(const uint8_t* x, uint32_t lenx, uint8_t* xmin, uint8_t* xmax, uint32_t ncols)
+{
+	uint32_t c, start, end;
+
+	if(lenx == 0)
+		return;
+
+	for(c = 0; c < ncols; c++){
+		start = (c * lenx)/ncols;
+		end = ((c + 1) * lenx)/ncols;
+		if(end <= start)
+			end = start + 1;		/* more columns than samples, repeat the sample */
+
+		minMaxU8(x + start, end - start, &xmin[c], &xmax[c]);
+	}
+}
+
 /**
   * @brief  Determine the set of filters needed for a desired sample rate conversion.
   * @param  origSR: Index of the sample rate of input
@@ -850,3 +1017,299 @@ static uint32_t getFiltDelay(uint8_t fact)
 
 	return (origlen - 1)/2;		/* grpdelay = filtorder/2 */
 }
+
+/**
+  * @brief  Find the min and max of an unsigned 8-bit array with minMaxSumU8(), the sums are
+  * 		dropped.
+  * @param  x: input array
+  * @param  len: length of x, must be > 0
+  * @param  pmin: min value
+  * @param  pmax: max value
+  * @retval None
+  */
+static void minMaxU8(const uint8_t* x, uint32_t len, uint8_t* pmin, uint8_t* pmax)
+{
+	uint32_t sum, sumsq;
+
+	minMaxSumU8(x, len, pmin, pmax, &sum, &sumsq);
+}
+
+/**
+  * @brief  Find the min, max, sum and sum of squares of an unsigned 8-bit array in a single pass,
+  * 		4 samples at a time: SIMD byte compare (USUB8 sets the GE flags) and select (SEL)
+  * 		for the min/max, USADA8 for the sum and UXTB16/SMLAD for the sum of squares.
+  * @param  x: input array
+  * @param  len: length of x, must be > 0
+  * @param  pmin: min value
+  * @param  pmax: max value
+  * @param  psum: sum of the values
+  * @param  psumsq: sum of the squared values
+  * @retval None
+  */
+void minMaxSumU8(const uint8_t* x, uint32_t len, uint8_t* pmin, uint8_t* pmax, uint32_t* psum, uint32_t* psumsq)
+{
+	uint32_t vmin = 0xFFFFFFFF, vmax = 0, sum = 0, sumsq = 0, v, t;
+	uint8_t mn, mx;
+
+	/* leading samples up to word alignment, broadcast to all lanes for min/max */
+	while(len > 0 && ((uint32_t)x & 0x3)){
+		v = *x * 0x01010101;
+		__USUB8(v, vmax);
+		vmax = __SEL(v, vmax);
+		__USUB8(v, vmin);
+		vmin = __SEL(vmin, v);
+		sum += *x;
+		sumsq += *x * *x;
+		x++;
+		len--;
+	}
+
+	/* 4 samples per iteration */
+	while(len >= 4){
+		v = *(const uint32_t *)x;
+		__USUB8(v, vmax);
+		vmax = __SEL(v, vmax);		/* bytewise max */
+		__USUB8(v, vmin);
+		vmin = __SEL(vmin, v);		/* bytewise min */
+		sum = __USADA8(v, 0, sum);	/* sum of the 4 bytes */
+		t = __UXTB16(v);			/* bytes 0 & 2 as halfwords */
+		sumsq = __SMLAD(t, t, sumsq);
+		t = __UXTB16(__ROR(v, 8));	/* bytes 1 & 3 as halfwords */
+		sumsq = __SMLAD(t, t, sumsq);
+		x += 4;
+		len -= 4;
+	}
+
+	/* reduce the 4 lanes */
+	mn = vmin & 0xFF;
+	mx = vmax & 0xFF;
+	for(v = 1; v < 4; v++){
+		if(((vmin >> 8*v) & 0xFF) < mn)  mn = (vmin >> 8*v) & 0xFF;
+		if(((vmax >> 8*v) & 0xFF) > mx)  mx = (vmax >> 8*v) & 0xFF;
+	}
+
+	/* remaining samples */
+	while(len > 0){
+		if(*x < mn)  mn = *x;
+		if(*x > mx)  mx = *x;
+		sum += *x;
+		sumsq += *x * *x;
+		x++;
+		len--;
+	}
+
+	*pmin = mn;
+	*pmax = mx;
+	*psum = sum;
+	*psumsq = sumsq;
+}
+
+/**
+  * @brief  Compute the math signal of the given samples into MATH_vals, once per acquisition or
+  * 		math setting change. A plain operation is one packed 8-bit SIMD kernel; with the
+  * 		low-pass filter or a function, the operation, filter and function are float vector
+  * 		kernels over mathVals, which is then scaled to 8-bit samples.
+  * @param  ch1: CH1 samples
+  * @param  ch2: CH2 samples
+  * @param  len: no. of samples, at most ADC_BUF_SIZE
+  * @retval None
+  */
+void calcMath(const uint8_t* ch1, const uint8_t* ch2, uint32_t len)
+{
+	static uint32_t lastSeq, lastLen;
+	static uint8_t lastOp = MATH_OP_NONE, lastFn, lastFilt;
+	arm_fir_instance_f32 S;
+	float32_t pad[MATH_FIR_DELAY];
+	float32_t v;
+	uint32_t i, n;
+
+	if(mathOp == MATH_OP_NONE)
+		return;
+
+	/* MATH_vals already holds this acquisition */
+	if(acqSeq == lastSeq && len == lastLen && mathOp == lastOp && mathFn == lastFn && mathFilt == lastFilt)
+		return;
+
+	lastSeq = acqSeq;
+	lastLen = len;
+	lastOp = mathOp;
+	lastFn = mathFn;
+	lastFilt = mathFilt;
+
+	if(mathFilt == MATH_FILT_OFF && mathFn == MATH_FN_NONE && mathOp != MATH_OP_1X2){
+		mathOpU8(ch1, ch2, MATH_vals, len);
+		mathGen++;
+		return;
+	}
+
+	/* operation */
+	if(mathOp == MATH_OP_CH2)
+		u8ToFloat(ch2, mathVals, len);
+	else
+		u8ToFloat(ch1, mathVals, len);
+
+	if(mathOp == MATH_OP_1P2 || mathOp == MATH_OP_1M2 || mathOp == MATH_OP_2M1 || mathOp == MATH_OP_1X2){
+		u8ToFloat(ch2, mathTmp, len);
+
+		if(mathOp == MATH_OP_1P2){
+			arm_add_f32(mathVals, mathTmp, mathVals, len);
+			arm_scale_f32(mathVals, 0.5f, mathVals, len);
+		}
+		else if(mathOp == MATH_OP_1M2){
+			arm_sub_f32(mathVals, mathTmp, mathVals, len);
+		}
+		else if(mathOp == MATH_OP_2M1){
+			arm_sub_f32(mathTmp, mathVals, mathVals, len);
+		}
+		else{
+			arm_mult_f32(mathVals, mathTmp, mathVals, len);
+			arm_scale_f32(mathVals, 1/256.0f, mathVals, len);
+		}
+	}
+
+	/* low-pass filter, delay compensated so that the result lines up with the channels */
+	if(mathFilt != MATH_FILT_OFF){
+		if(mathFirFilt != mathFilt)
+			genMathFir(mathFilt);
+
+		arm_fir_init_f32(&S, MATH_FIR_TAPS, mathFirCoeffs, mathFirState, MATH_FIR_BLOCK);
+		arm_fill_f32(mathVals[0], mathFirState, MATH_FIR_TAPS - 1);		/* settled on the first sample */
+		for(i = 0; i < len; i += n){
+			n = min(MATH_FIR_BLOCK, len - i);
+			arm_fir_f32(&S, mathVals + i, mathTmp + i, n);
+		}
+		arm_fill_f32(mathVals[len - 1], pad, MATH_FIR_DELAY);			/* and held on the last one */
+		arm_fir_f32(&S, pad, mathTmp + len, MATH_FIR_DELAY);
+		arm_copy_f32(mathTmp + MATH_FIR_DELAY, mathVals, len);
+	}
+
+	/* function */
+	if(mathFn == MATH_FN_INTEG){
+		v = 0;
+		for(i = 0; i < len; i++){
+			v += mathVals[i];
+			mathVals[i] = v;
+		}
+		arm_scale_f32(mathVals, 1.0f/MATH_DIV_SAMPLES, mathVals, len);
+	}
+	else if(mathFn == MATH_FN_DIFF){
+		arm_sub_f32(mathVals + 1, mathVals, mathTmp + 1, len - 1);
+		mathTmp[0] = mathTmp[1];
+		arm_scale_f32(mathTmp, MATH_DIV_SAMPLES, mathVals, len);
+	}
+	else if(mathFn == MATH_FN_ABS){
+		arm_abs_f32(mathVals, mathVals, len);
+	}
+	else if(mathFn == MATH_FN_INV || mathFn == MATH_FN_X2 || mathFn == MATH_FN_X10){
+		arm_scale_f32(mathVals, (mathFn == MATH_FN_INV) ? -1.0f : ((mathFn == MATH_FN_X2) ? 2.0f : 10.0f), mathVals, len);
+	}
+	else if(mathFn == MATH_FN_MID){
+		arm_offset_f32(mathVals, 128.0f, mathVals, len);
+	}
+
+	/* 8-bit samples */
+	for(i = 0; i < len; i++)
+		MATH_vals[i] = __USAT((int32_t)roundf(mathVals[i]/MATH_LSB) + MATH_ZERO, 8);
+
+	mathGen++;
+}
+
+/**
+  * @brief  Compute the 8-bit math samples of an operation (other than the product), 4 samples at
+  * 		a time using the SIMD halving add/subtract (UHADD8/UHSUB8) instructions. The halving
+  * 		gives the MATH_LSB scale directly, and XOR 0x80 adds MATH_ZERO to a signed byte.
+  * @param  x1: CH1 samples
+  * @param  x2: CH2 samples
+  * @param  y: output array
+  * @param  len: length of x1, x2
+  * @retval None
+  */
+static void mathOpU8(const uint8_t* x1, const uint8_t* x2, uint8_t* y, uint32_t len)
+{
+	uint32_t a, b, v;
+
+	/* 4 samples per iteration */
+	while(len >= 4){
+		a = *(const uint32_t *)x1;
+		b = *(const uint32_t *)x2;
+
+		if(mathOp == MATH_OP_1P2)
+			v = __UHADD8(__UHADD8(a, b), 0) | 0x80808080;		/* average (1 + 2)/2, halved once more to MATH_LSB */
+		else if(mathOp == MATH_OP_1M2)
+			v = __UHSUB8(a, b) ^ 0x80808080;
+		else if(mathOp == MATH_OP_2M1)
+			v = __UHSUB8(b, a) ^ 0x80808080;
+		else
+			v = __UHADD8((mathOp == MATH_OP_CH2) ? b : a, 0) | 0x80808080;
+
+		*(uint32_t *)y = v;
+		x1 += 4;
+		x2 += 4;
+		y += 4;
+		len -= 4;
+	}
+
+	/* remaining samples */
+	while(len > 0){
+		if(mathOp == MATH_OP_1P2)
+			*y = ((*x1 + *x2) >> 2) + MATH_ZERO;
+		else if(mathOp == MATH_OP_1M2)
+			*y = ((*x1 - *x2) >> 1) + MATH_ZERO;
+		else if(mathOp == MATH_OP_2M1)
+			*y = ((*x2 - *x1) >> 1) + MATH_ZERO;
+		else
+			*y = (((mathOp == MATH_OP_CH2) ? *x2 : *x1) >> 1) + MATH_ZERO;
+		x1++;
+		x2++;
+		y++;
+		len--;
+	}
+}
+
+/**
+  * @brief  Convert unsigned 8-bit samples to float.
+  * @param  x: input array
+  * @param  y: output array
+  * @param  len: length of x
+  * @retval None
+  */
+static void u8ToFloat(const uint8_t* x, float32_t* y, uint32_t len)
+{
+	/* 4 samples per iteration */
+	while(len >= 4){
+		y[0] = x[0];
+		y[1] = x[1];
+		y[2] = x[2];
+		y[3] = x[3];
+		x += 4;
+		y += 4;
+		len -= 4;
+	}
+
+	while(len > 0){
+		*y++ = *x++;
+		len--;
+	}
+}
+
+/**
+  * @brief  Generate the math low-pass filter: a Hamming windowed sinc, normalised to unity DC gain.
+  * @param  filt: cutoff, fs/2^(filt + 1)
+  * @retval None
+  */
+static void genMathFir(uint8_t filt)
+{
+	float32_t fc, sum = 0;
+	int32_t i, n;
+
+	fc = 0.5f/(1 << filt);
+	for(i = 0; i < MATH_FIR_TAPS; i++){
+		n = i - MATH_FIR_DELAY;
+		mathFirCoeffs[i] = (n == 0) ? 2*fc : arm_sin_f32(2*PI*fc*n)/(PI*n);
+		mathFirCoeffs[i] *= 0.54f - 0.46f*arm_cos_f32(2*PI*i/(MATH_FIR_TAPS - 1));
+		sum += mathFirCoeffs[i];
+	}
+	arm_scale_f32(mathFirCoeffs, 1/sum, mathFirCoeffs, MATH_FIR_TAPS);
+
+	mathFirFilt = filt;
+}
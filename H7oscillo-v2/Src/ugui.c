@@ -5276,6 +5276,12 @@ void _UG_PutChar( char chr, UG_S16 x, UG_S16 y, UG_COLOR fc, UG_COLOR bc, const
    }
 
    if (bt < font->start_char || bt > font->end_char) return;
+
+   /* Is a hardware-accelerated character driver available? */
+   if ( gui->driver[DRIVER_DRAW_CHAR].state & DRIVER_ENABLED )
+   {
+      if( ((UG_RESULT(*)(UG_U8, UG_S16, UG_S16, UG_COLOR, UG_COLOR, const UG_FONT*))gui->driver[DRIVER_DRAW_CHAR].driver)(bt,x,y,fc,bc,font) == UG_RESULT_OK ) return;
+   }
    
    yo = y;
    bn = font->char_width;
@@ -5968,6 +5974,62 @@ UG_RESULT UG_WindowHide( UG_WINDOW* wnd )
    return UG_RESULT_FAIL;
 }
 
+UG_RESULT UG_WindowSetVisible( UG_WINDOW* wnd, UG_U8 visible )
+{
+   if ( (wnd != NULL) && (wnd->state & WND_STATE_VALID) )
+   {
+      if ( visible )
+      {
+         /* Newly shown windows are drawn completely */
+         if ( !(wnd->state & WND_STATE_VISIBLE) )
+         {
+            wnd->state &= ~WND_STATE_REDRAW_TITLE;
+            wnd->state |= WND_STATE_VISIBLE | WND_STATE_UPDATE;
+         }
+      }
+      else
+      {
+         /* The caller is responsible for clearing the window area */
+         wnd->state &= ~(WND_STATE_VISIBLE | WND_STATE_UPDATE);
+      }
+      return UG_RESULT_OK;
+   }
+   return UG_RESULT_FAIL;
+}
+
+UG_RESULT UG_WindowInvalidate( UG_WINDOW* wnd )
+{
+   if ( (wnd != NULL) && (wnd->state & WND_STATE_VALID) )
+   {
+      /* Redraw the whole window on the next update */
+      if ( wnd->state & WND_STATE_VISIBLE )
+      {
+         wnd->state &= ~WND_STATE_REDRAW_TITLE;
+         wnd->state |= WND_STATE_UPDATE;
+      }
+      return UG_RESULT_OK;
+   }
+   return UG_RESULT_FAIL;
+}
+
+void UG_WindowUpdate( UG_WINDOW* wnd )
+{
+   if ( (wnd == NULL) || !(wnd->state & WND_STATE_VALID) ) return;
+
+   /* Same as UG_Update(), but for any visible window instead of only the active one */
+   if ( (wnd->state & WND_STATE_VISIBLE) && (wnd->state & WND_STATE_UPDATE) )
+   {
+      _UG_WindowUpdate( wnd );
+   }
+
+   if ( wnd->state & WND_STATE_VISIBLE )
+   {
+      _UG_ProcessTouchData( wnd );
+      _UG_UpdateObjects( wnd );
+      _UG_HandleEvents( wnd );
+   }
+}
+
 UG_RESULT UG_WindowResize( UG_WINDOW* wnd, UG_S16 xs, UG_S16 ys, UG_S16 xe, UG_S16 ye )
 {
    UG_S16 pos;
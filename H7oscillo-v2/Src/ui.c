@@ -10,9 +10,14 @@
 #include "ui.h"
 
 
-static void drawGridHoriz(void);
+static void drawGridRect(UG_S16 x1, UG_S16 y1, UG_S16 x2, UG_S16 y2);
 static void drawGridVerti(void);
+static void dispFFTFreqs(void);
+static void dispFFTEngine(void);
+static void dispFFTPeaks(void);
+static void renderGridSurface(uint32_t addr, uint8_t horiz, uint8_t separator);
 static void selectField(uint8_t field, uint8_t sel);
+static void invalidateCursorLines(void);
 static void window_1_callback(UG_MESSAGE* msg);
 static void window_2_callback(UG_MESSAGE* msg);
 static void window_3_callback(UG_MESSAGE* msg);
@@ -24,10 +29,14 @@ static void window_8_callback(UG_MESSAGE* msg);
 static void window_9_callback(UG_MESSAGE* msg);
 static void window_10_callback(UG_MESSAGE* msg);
 static void window_11_callback(UG_MESSAGE* msg);
+static void window_12_callback(UG_MESSAGE* msg);
 static uint16_t findNextValidFile(uint16_t x);
 static uint16_t findPrevValidFile(uint16_t x);
 static uint8_t readssinfo(uint8_t* nScrnshots, uint16_t* maxfilename);
 static uint8_t writessinfo(uint8_t nScrnshots, uint16_t maxfilename);
+static void measToStr(const Measure_TypeDef* meas, char* buf);
+static void measValToStr(uint8_t param, float32_t val, char* buf);
+static void DisplayMeasStats(void);
 
 /* uGUI related globals */
 UG_GUI gui;
@@ -72,49 +81,95 @@ UG_BUTTON button4_3;
 UG_BUTTON button4_4;
 /* window 5 - Measure submenu */
 UG_WINDOW window_5;
-UG_OBJECT obj_buff_wnd_5[4];
+UG_OBJECT obj_buff_wnd_5[14];
 UG_TEXTBOX txtb5_0;
 UG_TEXTBOX txtb5_1;
+UG_TEXTBOX txtb5_2;
+UG_TEXTBOX txtb5_3;
+UG_TEXTBOX txtb5_4;
+UG_TEXTBOX txtb5_5;
+UG_TEXTBOX txtb5_6;
+UG_TEXTBOX txtb5_7;
+UG_TEXTBOX txtb5_8;
 UG_BUTTON button5_0;
 UG_BUTTON button5_1;
+UG_BUTTON button5_2;
+UG_BUTTON button5_3;
+UG_BUTTON button5_4;
 /* window 6 - Display mode submenu */
 UG_WINDOW window_6;
-UG_OBJECT obj_buff_wnd_6[2];
+UG_OBJECT obj_buff_wnd_6[8];
 UG_TEXTBOX txtb6_0;
+UG_TEXTBOX txtb6_1;
+UG_TEXTBOX txtb6_2;
+UG_TEXTBOX txtb6_3;
 UG_BUTTON button6_0;
+UG_BUTTON button6_1;
+UG_BUTTON button6_2;
+UG_BUTTON button6_3;
 /* window 7 - FFT submenu */
 UG_WINDOW window_7;
-UG_OBJECT obj_buff_wnd_7[2];
+UG_OBJECT obj_buff_wnd_7[18];
 UG_TEXTBOX txtb7_0;
+UG_TEXTBOX txtb7_1;
+UG_TEXTBOX txtb7_2;
+UG_TEXTBOX txtb7_3;
+UG_TEXTBOX txtb7_4;
+UG_TEXTBOX txtb7_5;
+UG_TEXTBOX txtb7_6;
+UG_TEXTBOX txtb7_7;
+UG_TEXTBOX txtb7_8;
 UG_BUTTON button7_0;
+UG_BUTTON button7_1;
+UG_BUTTON button7_2;
+UG_BUTTON button7_3;
+UG_BUTTON button7_4;
+UG_BUTTON button7_5;
+UG_BUTTON button7_6;
+UG_BUTTON button7_7;
+UG_BUTTON button7_8;
 /* window 8 - FFT submenu sub-menu */
 UG_WINDOW window_8;
 UG_OBJECT obj_buff_wnd_8[1];
 UG_TEXTBOX txtb8_0;
 /* window 9 - Math submenu */
 UG_WINDOW window_9;
-UG_OBJECT obj_buff_wnd_9[6];
+UG_OBJECT obj_buff_wnd_9[10];
 UG_TEXTBOX txtb9_0;
 UG_TEXTBOX txtb9_1;
 UG_TEXTBOX txtb9_2;
+UG_TEXTBOX txtb9_3;
+UG_TEXTBOX txtb9_4;
 UG_BUTTON button9_0;
 UG_BUTTON button9_1;
 UG_BUTTON button9_2;
+UG_BUTTON button9_3;
+UG_BUTTON button9_4;
 /* window 10 - Cursors submenu */
 UG_WINDOW window_10;
-UG_OBJECT obj_buff_wnd_10[8];
+UG_OBJECT obj_buff_wnd_10[10];
 UG_TEXTBOX txtb10_0;
 UG_TEXTBOX txtb10_1;
 UG_TEXTBOX txtb10_2;
 UG_TEXTBOX txtb10_3;
 UG_TEXTBOX txtb10_4;
+UG_TEXTBOX txtb10_5;
 UG_BUTTON button10_0;
 UG_BUTTON button10_1;
 UG_BUTTON button10_2;
+UG_BUTTON button10_3;
 /* window 11 - Cursors submenu */
 UG_WINDOW window_11;
 UG_OBJECT obj_buff_wnd_11[1];
 UG_TEXTBOX txtb11_0;
+/* window 12 - Spectrum peak table */
+UG_WINDOW window_12;
+UG_OBJECT obj_buff_wnd_12[FFT_PEAKS_MAX];
+UG_TEXTBOX txtb12_0;
+UG_TEXTBOX txtb12_1;
+UG_TEXTBOX txtb12_2;
+UG_TEXTBOX txtb12_3;
+UG_TEXTBOX txtb12_4;
 
 /* Menu page display selector flags */
 static uint8_t showWindow3 = 0;
@@ -125,6 +180,13 @@ static uint8_t showWindow7 = 0;
 static uint8_t showWindow8 = 0;
 static uint8_t showWindow9 = 0;
 static uint8_t showWindow10 = 0;
+static uint8_t showWindow12 = 0;
+
+/* Windows drawn by the compositor, in drawing order */
+static UG_WINDOW* const uiWindows[NUM_UI_WINDOWS] = {
+		[SLOT_WINDOW1] = &window_1, [SLOT_WINDOW2] = &window_2, [SLOT_WINDOW3] = &window_3, [SLOT_WINDOW4] = &window_4,
+		[SLOT_WINDOW5] = &window_5, [SLOT_WINDOW6] = &window_6, [SLOT_WINDOW7] = &window_7, [SLOT_WINDOW8] = &window_8,
+		[SLOT_WINDOW9] = &window_9, [SLOT_WINDOW10] = &window_10, [SLOT_WINDOW12] = &window_12};
 
 static uint8_t wind5OpenedBy = MEASURE_NONE;
 static uint8_t currField = FLD_NONE;					/* currently selected field in the top and bottom menubar */
@@ -135,11 +197,23 @@ static uint8_t cursorMode = CURSOR_MODE_OFF;
 static uint16_t cursorApos = CURSORA_SPLITCH1_INITPOS;
 static uint16_t cursorBpos = CURSORB_SPLITCH2_INITPOS;
 static uint8_t cursorField = CURSORFLD_NONE;			/* currently selected field in the cursor menu */
+static uint8_t cursorGate = 0;							/* restrict the measurements to between the dT cursors */
 
 static uint16_t currScrnshot = 0;						/* currently displayed screenshot */
 
+static const char fftSpanTexts[FFT_ZOOM_MAX + 1][5] = {"Full", "1/2", "1/4", "1/8", "1/16", "1/32", "1/64"};	/* spectrum spans */
+static const char fftWindowTexts[FFTWIN_NUM][10] = {"Rect", "Hann", "BlkHarris", "FlatTop"};
+static const char fftAvgTexts[FFT_AVG_MAX + 1][4] = {"OFF", "2", "4", "8", "16", "32", "64"};		/* no. of frames averaged */
+static const char fftHoldTexts[4][8] = {"OFF", "Max", "Min", "Max+Min"};
+static const char fftPeaksTexts[3][8] = {"OFF", "Table", "Tbl+Harm"};
+static const char mathOpTexts[MATH_OP_NUM][6] = {"OFF", "1 + 2", "1 - 2", "2 - 1", "1 x 2", "1", "2"};
+static const char mathFnTexts[MATH_FN_NUM][7] = {"OFF", "Integ", "Diff", "Abs", "x(-1)", "x2", "x10", "+1.65V"};
+static const char mathFiltTexts[MATH_FILT_MAX + 1][6] = {"OFF", "fs/4", "fs/8", "fs/16"};	/* low-pass cutoffs */
+static const char measSrcTexts[CHANNELMATH + 1][5] = {"", "CH1", "CH2", "Math"};			/* measurement sources */
+static const UG_COLOR measSrcColors[CHANNELMATH + 1] = {INACTIVE_ICON_COLOR, CH1_COLOR, CH2_COLOR, MATH_COLOR};
+
 /* strings to store button & textbox texts */
-static char bufw1tb3[8] = "Trg:", bufw1tb4[6], bufw2tb0[6], bufw2tb1[6], bufw2tb2[8], bufw8tb0[9], bufw9btn2[6], bufw10btn1[8], bufw10btn2[8], bufw10tb4[8];
+static char bufw1tb3[8] = "Trg:", bufw1tb4[6], bufw2tb0[6], bufw2tb1[6], bufw2tb2[8], bufw7btn3[9], bufw7btn7[16], bufw8tb0[9], bufw9btn2[6], bufw10btn1[8], bufw10btn2[8], bufw10tb4[8], bufw5btn4[3], bufw12tb[FFT_PEAKS_MAX][20];
 
 static uint8_t trigCursorImg[CURSOR_WIDTH][CURSOR_LENGTH] = {
 	   {1, 1, 1, 1, 1, 1, 1, 1, 1, 0, 0, 0, 0},
@@ -232,6 +306,8 @@ static uint8_t mathRefCursorImg[CURSOR_WIDTH][CURSOR_LENGTH] = {
   */
 void initUI(void)
 {
+	uint8_t i;
+
 	/*** Create Window 1 (Top menubar) ***/
 	UG_WindowCreate(&window_1, obj_buff_wnd_1, 8, window_1_callback);
 	UG_WindowSetStyle(&window_1, WND_STYLE_2D | WND_STYLE_HIDE_TITLE);
@@ -322,7 +398,10 @@ void initUI(void)
 	UG_TextboxSetBackColor(&window_2, TXB_ID_6, INACTIVE_ICON_COLOR);
 	UG_TextboxSetText(&window_2, TXB_ID_6, "--");
 
-	/* draw grid */
+	/* pre-render the grid variants and draw the grid */
+	renderGridSurface(GRID_SURFACE_SPLIT, 1, 1);
+	renderGridSurface(GRID_SURFACE_MERGE, 1, 0);
+	renderGridSurface(GRID_SURFACE_FFT, 0, 0);
 	drawGrid();
 
 	/*** Create Window 3 (Measure window) ***/
@@ -398,7 +477,7 @@ void initUI(void)
 	UG_ButtonSetText(&window_4, BTN_ID_4, "<");
 
 	/*** Create Window 5 (Measurement sub-menu) ***/
-	UG_WindowCreate(&window_5, obj_buff_wnd_5, 4, window_5_callback);
+	UG_WindowCreate(&window_5, obj_buff_wnd_5, 14, window_5_callback);
 	UG_WindowSetStyle(&window_5, WND_STYLE_3D | WND_STYLE_HIDE_TITLE);
 	UG_WindowResize(&window_5, WIND5_X_START, WIND5_Y_START, WIND5_X_START + WIND5_WIDTH - 1, WIND5_Y_START + WIND5_HEIGHT - 1);
 	UG_WindowSetBackColor(&window_5, C_WHITE);
@@ -423,8 +502,59 @@ void initUI(void)
 	UG_ButtonSetBackColor(&window_5, BTN_ID_1, C_OLIVE);
 	UG_ButtonSetText(&window_5, BTN_ID_1, "Freq");
 
+	UG_TextboxCreate(&window_5, &txtb5_2, TXB_ID_2, 1, 2*WIND5_BTN_HEIGHT + 2*WIND5_BTN_SPACING + 1, WIND5_BTN_WIDTH, 3*WIND5_BTN_HEIGHT + 2*WIND5_BTN_SPACING);		/* label */
+	UG_TextboxSetFont(&window_5, TXB_ID_2, &FONT_6X8);
+	UG_TextboxSetAlignment(&window_5, TXB_ID_2, ALIGN_CENTER_RIGHT);
+	UG_TextboxSetText(&window_5, TXB_ID_2, "stats:");
+
+	UG_TextboxCreate(&window_5, &txtb5_3, TXB_ID_3, 1, 3*WIND5_BTN_HEIGHT + 3*WIND5_BTN_SPACING + 1, WIND5_BTN_WIDTH, 4*WIND5_BTN_HEIGHT + 3*WIND5_BTN_SPACING);		/* no. of acquisitions */
+	UG_TextboxSetFont(&window_5, TXB_ID_3, &FONT_6X8);
+	UG_TextboxSetAlignment(&window_5, TXB_ID_3, ALIGN_CENTER_RIGHT);
+	UG_TextboxSetText(&window_5, TXB_ID_3, "n:0");
+
+	UG_TextboxCreate(&window_5, &txtb5_4, TXB_ID_4, 1, WIND5_STATS_Y_START, WIND5_WIDTH - 5, WIND5_STATS_Y_START + WIND5_STATS_LINE_HEIGHT - 1);		/* mean */
+	UG_TextboxSetFont(&window_5, TXB_ID_4, &FONT_6X8);
+	UG_TextboxSetAlignment(&window_5, TXB_ID_4, ALIGN_CENTER_LEFT);
+	UG_TextboxSetText(&window_5, TXB_ID_4, "mean:");
+
+	UG_TextboxCreate(&window_5, &txtb5_5, TXB_ID_5, 1, WIND5_STATS_Y_START + WIND5_STATS_LINE_HEIGHT, WIND5_WIDTH - 5, WIND5_STATS_Y_START + 2*WIND5_STATS_LINE_HEIGHT - 1);		/* min */
+	UG_TextboxSetFont(&window_5, TXB_ID_5, &FONT_6X8);
+	UG_TextboxSetAlignment(&window_5, TXB_ID_5, ALIGN_CENTER_LEFT);
+	UG_TextboxSetText(&window_5, TXB_ID_5, "min:");
+
+	UG_TextboxCreate(&window_5, &txtb5_6, TXB_ID_6, 1, WIND5_STATS_Y_START + 2*WIND5_STATS_LINE_HEIGHT, WIND5_WIDTH - 5, WIND5_STATS_Y_START + 3*WIND5_STATS_LINE_HEIGHT - 1);		/* max */
+	UG_TextboxSetFont(&window_5, TXB_ID_6, &FONT_6X8);
+	UG_TextboxSetAlignment(&window_5, TXB_ID_6, ALIGN_CENTER_LEFT);
+	UG_TextboxSetText(&window_5, TXB_ID_6, "max:");
+
+	UG_TextboxCreate(&window_5, &txtb5_7, TXB_ID_7, 1, WIND5_STATS_Y_START + 3*WIND5_STATS_LINE_HEIGHT, WIND5_WIDTH - 5, WIND5_STATS_Y_START + 4*WIND5_STATS_LINE_HEIGHT - 1);		/* std. deviation */
+	UG_TextboxSetFont(&window_5, TXB_ID_7, &FONT_6X8);
+	UG_TextboxSetAlignment(&window_5, TXB_ID_7, ALIGN_CENTER_LEFT);
+	UG_TextboxSetText(&window_5, TXB_ID_7, "sd:");
+
+	UG_ButtonCreate(&window_5, &button5_2, BTN_ID_2, 71, 2*WIND5_BTN_HEIGHT + 2*WIND5_BTN_SPACING + 1, 71 + WIND5_BTN_WIDTH - 1, 3*WIND5_BTN_HEIGHT + 2*WIND5_BTN_SPACING);	/* statistics on/off */
+	UG_ButtonSetFont(&window_5, BTN_ID_2, &FONT_6X8);
+	UG_ButtonSetBackColor(&window_5, BTN_ID_2, C_OLIVE);
+	UG_ButtonSetText(&window_5, BTN_ID_2, "OFF");
+
+	UG_ButtonCreate(&window_5, &button5_3, BTN_ID_3, 71, 3*WIND5_BTN_HEIGHT + 3*WIND5_BTN_SPACING + 1, 71 + WIND5_BTN_WIDTH - 1, 4*WIND5_BTN_HEIGHT + 3*WIND5_BTN_SPACING);	/* statistics reset */
+	UG_ButtonSetFont(&window_5, BTN_ID_3, &FONT_6X8);
+	UG_ButtonSetBackColor(&window_5, BTN_ID_3, C_OLIVE);
+	UG_ButtonSetText(&window_5, BTN_ID_3, "Reset");
+
+	UG_TextboxCreate(&window_5, &txtb5_8, TXB_ID_8, 1, 4*WIND5_BTN_HEIGHT + 4*WIND5_BTN_SPACING + 1, WIND5_BTN_WIDTH, 5*WIND5_BTN_HEIGHT + 4*WIND5_BTN_SPACING);		/* label */
+	UG_TextboxSetFont(&window_5, TXB_ID_8, &FONT_6X8);
+	UG_TextboxSetAlignment(&window_5, TXB_ID_8, ALIGN_CENTER_RIGHT);
+	UG_TextboxSetText(&window_5, TXB_ID_8, "harm:");
+
+	UG_ButtonCreate(&window_5, &button5_4, BTN_ID_4, 71, 4*WIND5_BTN_HEIGHT + 4*WIND5_BTN_SPACING + 1, 71 + WIND5_BTN_WIDTH - 1, 5*WIND5_BTN_HEIGHT + 4*WIND5_BTN_SPACING);	/* highest harmonic in THD */
+	UG_ButtonSetFont(&window_5, BTN_ID_4, &FONT_6X8);
+	UG_ButtonSetBackColor(&window_5, BTN_ID_4, C_OLIVE);
+	itoa(measHarmonics, bufw5btn4, 10);
+	UG_ButtonSetText(&window_5, BTN_ID_4, bufw5btn4);
+
 	/*** Create Window 6 (Display mode sub-menu) ***/
-	UG_WindowCreate(&window_6, obj_buff_wnd_6, 2, window_6_callback);
+	UG_WindowCreate(&window_6, obj_buff_wnd_6, 8, window_6_callback);
 	UG_WindowSetStyle(&window_6, WND_STYLE_3D | WND_STYLE_HIDE_TITLE);
 	UG_WindowResize(&window_6, WIND6_X_START, WIND6_Y_START, WIND6_X_START + WIND6_WIDTH - 1, WIND6_Y_START + WIND6_HEIGHT - 1);
 	UG_WindowSetBackColor(&window_6, C_WHITE);
@@ -434,13 +564,43 @@ void initUI(void)
 	UG_TextboxSetAlignment(&window_6, TXB_ID_0, ALIGN_CENTER_RIGHT);
 	UG_TextboxSetText(&window_6, TXB_ID_0, "Mode:");
 
+	UG_TextboxCreate(&window_6, &txtb6_1, TXB_ID_1, 1, WIND6_BTN_HEIGHT + WIND6_BTN_SPACING + 1, WIND6_BTN_WIDTH, 2*WIND6_BTN_HEIGHT + WIND6_BTN_SPACING);	/* label */
+	UG_TextboxSetFont(&window_6, TXB_ID_1, &FONT_6X8);
+	UG_TextboxSetAlignment(&window_6, TXB_ID_1, ALIGN_CENTER_RIGHT);
+	UG_TextboxSetText(&window_6, TXB_ID_1, "Persist:");
+
+	UG_TextboxCreate(&window_6, &txtb6_2, TXB_ID_2, 1, 2*WIND6_BTN_HEIGHT + 2*WIND6_BTN_SPACING + 1, WIND6_BTN_WIDTH, 3*WIND6_BTN_HEIGHT + 2*WIND6_BTN_SPACING);	/* label */
+	UG_TextboxSetFont(&window_6, TXB_ID_2, &FONT_6X8);
+	UG_TextboxSetAlignment(&window_6, TXB_ID_2, ALIGN_CENTER_RIGHT);
+	UG_TextboxSetText(&window_6, TXB_ID_2, "Draw:");
+
+	UG_TextboxCreate(&window_6, &txtb6_3, TXB_ID_3, 1, 3*WIND6_BTN_HEIGHT + 3*WIND6_BTN_SPACING + 1, WIND6_BTN_WIDTH, 4*WIND6_BTN_HEIGHT + 3*WIND6_BTN_SPACING);	/* label */
+	UG_TextboxSetFont(&window_6, TXB_ID_3, &FONT_6X8);
+	UG_TextboxSetAlignment(&window_6, TXB_ID_3, ALIGN_CENTER_RIGHT);
+	UG_TextboxSetText(&window_6, TXB_ID_3, "Zoom:");
+
 	UG_ButtonCreate(&window_6, &button6_0, BTN_ID_0, 71, 1, 71 + WIND6_BTN_WIDTH - 1, WIND6_BTN_HEIGHT);	/* mode select */
 	UG_ButtonSetFont(&window_6, BTN_ID_0, &FONT_6X8);
 	UG_ButtonSetBackColor(&window_6, BTN_ID_0, C_OLIVE);
 	UG_ButtonSetText(&window_6, BTN_ID_0, "Split");
 
+	UG_ButtonCreate(&window_6, &button6_1, BTN_ID_1, 71, WIND6_BTN_HEIGHT + WIND6_BTN_SPACING + 1, 71 + WIND6_BTN_WIDTH - 1, 2*WIND6_BTN_HEIGHT + WIND6_BTN_SPACING + 1);	/* XY persistence */
+	UG_ButtonSetFont(&window_6, BTN_ID_1, &FONT_6X8);
+	UG_ButtonSetBackColor(&window_6, BTN_ID_1, C_OLIVE);
+	UG_ButtonSetText(&window_6, BTN_ID_1, "OFF");
+
+	UG_ButtonCreate(&window_6, &button6_2, BTN_ID_2, 71, 2*WIND6_BTN_HEIGHT + 2*WIND6_BTN_SPACING + 1, 71 + WIND6_BTN_WIDTH - 1, 3*WIND6_BTN_HEIGHT + 2*WIND6_BTN_SPACING + 1);	/* XY dots/lines */
+	UG_ButtonSetFont(&window_6, BTN_ID_2, &FONT_6X8);
+	UG_ButtonSetBackColor(&window_6, BTN_ID_2, C_OLIVE);
+	UG_ButtonSetText(&window_6, BTN_ID_2, "Dots");
+
+	UG_ButtonCreate(&window_6, &button6_3, BTN_ID_3, 71, 3*WIND6_BTN_HEIGHT + 3*WIND6_BTN_SPACING + 1, 71 + WIND6_BTN_WIDTH - 1, 4*WIND6_BTN_HEIGHT + 3*WIND6_BTN_SPACING + 1);	/* static mode zoom view */
+	UG_ButtonSetFont(&window_6, BTN_ID_3, &FONT_6X8);
+	UG_ButtonSetBackColor(&window_6, BTN_ID_3, C_OLIVE);
+	UG_ButtonSetText(&window_6, BTN_ID_3, "Split");
+
 	/*** Create Window 7 (FFT sub-menu) ***/
-	UG_WindowCreate(&window_7, obj_buff_wnd_7, 2, window_7_callback);
+	UG_WindowCreate(&window_7, obj_buff_wnd_7, 18, window_7_callback);
 	UG_WindowSetStyle(&window_7, WND_STYLE_3D | WND_STYLE_HIDE_TITLE);
 	UG_WindowResize(&window_7, WIND7_X_START, WIND7_Y_START, WIND7_X_START + WIND7_WIDTH - 1, WIND7_Y_START + WIND7_HEIGHT - 1);
 	UG_WindowSetBackColor(&window_7, C_WHITE);
@@ -450,11 +610,91 @@ void initUI(void)
 	UG_TextboxSetAlignment(&window_7, TXB_ID_0, ALIGN_CENTER_RIGHT);
 	UG_TextboxSetText(&window_7, TXB_ID_0, "Source:");
 
+	UG_TextboxCreate(&window_7, &txtb7_1, TXB_ID_1, 1, WIND7_BTN_HEIGHT + WIND7_BTN_SPACING + 1, WIND7_BTN_WIDTH, 2*WIND7_BTN_HEIGHT + WIND7_BTN_SPACING);	/* label */
+	UG_TextboxSetFont(&window_7, TXB_ID_1, &FONT_6X8);
+	UG_TextboxSetAlignment(&window_7, TXB_ID_1, ALIGN_CENTER_RIGHT);
+	UG_TextboxSetText(&window_7, TXB_ID_1, "View:");
+
 	UG_ButtonCreate(&window_7, &button7_0, BTN_ID_0, 71, 1, 71 + WIND7_BTN_WIDTH - 1, WIND7_BTN_HEIGHT);	/* FFT source select */
 	UG_ButtonSetFont(&window_7, BTN_ID_0, &FONT_6X8);
 	UG_ButtonSetBackColor(&window_7, BTN_ID_0, C_OLIVE);
 	UG_ButtonSetText(&window_7, BTN_ID_0, "OFF");
 
+	UG_ButtonCreate(&window_7, &button7_1, BTN_ID_1, 71, WIND7_BTN_HEIGHT + WIND7_BTN_SPACING + 1, 71 + WIND7_BTN_WIDTH - 1, 2*WIND7_BTN_HEIGHT + WIND7_BTN_SPACING);	/* spectrum/waterfall select */
+	UG_ButtonSetFont(&window_7, BTN_ID_1, &FONT_6X8);
+	UG_ButtonSetBackColor(&window_7, BTN_ID_1, C_OLIVE);
+	UG_ButtonSetText(&window_7, BTN_ID_1, "Spectrum");
+
+	UG_TextboxCreate(&window_7, &txtb7_2, TXB_ID_2, 1, 2*WIND7_BTN_HEIGHT + 2*WIND7_BTN_SPACING + 1, WIND7_BTN_WIDTH, 3*WIND7_BTN_HEIGHT + 2*WIND7_BTN_SPACING);	/* label */
+	UG_TextboxSetFont(&window_7, TXB_ID_2, &FONT_6X8);
+	UG_TextboxSetAlignment(&window_7, TXB_ID_2, ALIGN_CENTER_RIGHT);
+	UG_TextboxSetText(&window_7, TXB_ID_2, "Span:");
+
+	UG_TextboxCreate(&window_7, &txtb7_3, TXB_ID_3, 1, 3*WIND7_BTN_HEIGHT + 3*WIND7_BTN_SPACING + 1, WIND7_BTN_WIDTH, 4*WIND7_BTN_HEIGHT + 3*WIND7_BTN_SPACING);	/* label */
+	UG_TextboxSetFont(&window_7, TXB_ID_3, &FONT_6X8);
+	UG_TextboxSetAlignment(&window_7, TXB_ID_3, ALIGN_CENTER_RIGHT);
+	UG_TextboxSetText(&window_7, TXB_ID_3, "Center:");
+
+	UG_ButtonCreate(&window_7, &button7_2, BTN_ID_2, 71, 2*WIND7_BTN_HEIGHT + 2*WIND7_BTN_SPACING + 1, 71 + WIND7_BTN_WIDTH - 1, 3*WIND7_BTN_HEIGHT + 2*WIND7_BTN_SPACING);	/* spectrum span select */
+	UG_ButtonSetFont(&window_7, BTN_ID_2, &FONT_6X8);
+	UG_ButtonSetBackColor(&window_7, BTN_ID_2, C_OLIVE);
+	UG_ButtonSetText(&window_7, BTN_ID_2, fftSpanTexts[0]);
+
+	UG_ButtonCreate(&window_7, &button7_3, BTN_ID_3, 71, 3*WIND7_BTN_HEIGHT + 3*WIND7_BTN_SPACING + 1, 71 + WIND7_BTN_WIDTH - 1, 4*WIND7_BTN_HEIGHT + 3*WIND7_BTN_SPACING);	/* center the span on the marker */
+	UG_ButtonSetFont(&window_7, BTN_ID_3, &FONT_6X8);
+	UG_ButtonSetBackColor(&window_7, BTN_ID_3, C_OLIVE);
+	UG_ButtonSetText(&window_7, BTN_ID_3, "--");
+
+	UG_TextboxCreate(&window_7, &txtb7_4, TXB_ID_4, 1, 4*WIND7_BTN_HEIGHT + 4*WIND7_BTN_SPACING + 1, WIND7_BTN_WIDTH, 5*WIND7_BTN_HEIGHT + 4*WIND7_BTN_SPACING);	/* label */
+	UG_TextboxSetFont(&window_7, TXB_ID_4, &FONT_6X8);
+	UG_TextboxSetAlignment(&window_7, TXB_ID_4, ALIGN_CENTER_RIGHT);
+	UG_TextboxSetText(&window_7, TXB_ID_4, "Window:");
+
+	UG_TextboxCreate(&window_7, &txtb7_5, TXB_ID_5, 1, 5*WIND7_BTN_HEIGHT + 5*WIND7_BTN_SPACING + 1, WIND7_BTN_WIDTH, 6*WIND7_BTN_HEIGHT + 5*WIND7_BTN_SPACING);	/* label */
+	UG_TextboxSetFont(&window_7, TXB_ID_5, &FONT_6X8);
+	UG_TextboxSetAlignment(&window_7, TXB_ID_5, ALIGN_CENTER_RIGHT);
+	UG_TextboxSetText(&window_7, TXB_ID_5, "Avg:");
+
+	UG_TextboxCreate(&window_7, &txtb7_6, TXB_ID_6, 1, 6*WIND7_BTN_HEIGHT + 6*WIND7_BTN_SPACING + 1, WIND7_BTN_WIDTH, 7*WIND7_BTN_HEIGHT + 6*WIND7_BTN_SPACING);	/* label */
+	UG_TextboxSetFont(&window_7, TXB_ID_6, &FONT_6X8);
+	UG_TextboxSetAlignment(&window_7, TXB_ID_6, ALIGN_CENTER_RIGHT);
+	UG_TextboxSetText(&window_7, TXB_ID_6, "Hold:");
+
+	UG_ButtonCreate(&window_7, &button7_4, BTN_ID_4, 71, 4*WIND7_BTN_HEIGHT + 4*WIND7_BTN_SPACING + 1, 71 + WIND7_BTN_WIDTH - 1, 5*WIND7_BTN_HEIGHT + 4*WIND7_BTN_SPACING);	/* spectrum window select */
+	UG_ButtonSetFont(&window_7, BTN_ID_4, &FONT_6X8);
+	UG_ButtonSetBackColor(&window_7, BTN_ID_4, C_OLIVE);
+	UG_ButtonSetText(&window_7, BTN_ID_4, fftWindowTexts[FFTWIN_HANN]);
+
+	UG_ButtonCreate(&window_7, &button7_5, BTN_ID_5, 71, 5*WIND7_BTN_HEIGHT + 5*WIND7_BTN_SPACING + 1, 71 + WIND7_BTN_WIDTH - 1, 6*WIND7_BTN_HEIGHT + 5*WIND7_BTN_SPACING);	/* power averaging select */
+	UG_ButtonSetFont(&window_7, BTN_ID_5, &FONT_6X8);
+	UG_ButtonSetBackColor(&window_7, BTN_ID_5, C_OLIVE);
+	UG_ButtonSetText(&window_7, BTN_ID_5, fftAvgTexts[0]);
+
+	UG_ButtonCreate(&window_7, &button7_6, BTN_ID_6, 71, 6*WIND7_BTN_HEIGHT + 6*WIND7_BTN_SPACING + 1, 71 + WIND7_BTN_WIDTH - 1, 7*WIND7_BTN_HEIGHT + 6*WIND7_BTN_SPACING);	/* max/min hold select */
+	UG_ButtonSetFont(&window_7, BTN_ID_6, &FONT_6X8);
+	UG_ButtonSetBackColor(&window_7, BTN_ID_6, C_OLIVE);
+	UG_ButtonSetText(&window_7, BTN_ID_6, fftHoldTexts[0]);
+
+	UG_TextboxCreate(&window_7, &txtb7_7, TXB_ID_7, 1, 7*WIND7_BTN_HEIGHT + 7*WIND7_BTN_SPACING + 1, WIND7_BTN_WIDTH, 8*WIND7_BTN_HEIGHT + 7*WIND7_BTN_SPACING);	/* label */
+	UG_TextboxSetFont(&window_7, TXB_ID_7, &FONT_6X8);
+	UG_TextboxSetAlignment(&window_7, TXB_ID_7, ALIGN_CENTER_RIGHT);
+	UG_TextboxSetText(&window_7, TXB_ID_7, "Engine:");
+
+	UG_ButtonCreate(&window_7, &button7_7, BTN_ID_7, 71, 7*WIND7_BTN_HEIGHT + 7*WIND7_BTN_SPACING + 1, 71 + WIND7_BTN_WIDTH - 1, 8*WIND7_BTN_HEIGHT + 7*WIND7_BTN_SPACING);	/* float/q15 select, with the time taken */
+	UG_ButtonSetFont(&window_7, BTN_ID_7, &FONT_6X8);
+	UG_ButtonSetBackColor(&window_7, BTN_ID_7, C_OLIVE);
+	UG_ButtonSetText(&window_7, BTN_ID_7, "Float");
+
+	UG_TextboxCreate(&window_7, &txtb7_8, TXB_ID_8, 1, 8*WIND7_BTN_HEIGHT + 8*WIND7_BTN_SPACING + 1, WIND7_BTN_WIDTH, 9*WIND7_BTN_HEIGHT + 8*WIND7_BTN_SPACING);	/* label */
+	UG_TextboxSetFont(&window_7, TXB_ID_8, &FONT_6X8);
+	UG_TextboxSetAlignment(&window_7, TXB_ID_8, ALIGN_CENTER_RIGHT);
+	UG_TextboxSetText(&window_7, TXB_ID_8, "Peaks:");
+
+	UG_ButtonCreate(&window_7, &button7_8, BTN_ID_8, 71, 8*WIND7_BTN_HEIGHT + 8*WIND7_BTN_SPACING + 1, 71 + WIND7_BTN_WIDTH - 1, 9*WIND7_BTN_HEIGHT + 8*WIND7_BTN_SPACING);	/* peak table/harmonic markers select */
+	UG_ButtonSetFont(&window_7, BTN_ID_8, &FONT_6X8);
+	UG_ButtonSetBackColor(&window_7, BTN_ID_8, C_OLIVE);
+	UG_ButtonSetText(&window_7, BTN_ID_8, fftPeaksTexts[0]);
+
 	/*** Create Window 8 (FFT sub-menu sub-menu) ***/
 	UG_WindowCreate(&window_8, obj_buff_wnd_8, 1, window_8_callback);
 	UG_WindowSetStyle(&window_8, WND_STYLE_2D | WND_STYLE_HIDE_TITLE);
@@ -467,7 +707,7 @@ void initUI(void)
 	UG_TextboxSetText(&window_8, TXB_ID_0, "0Hz");
 
 	/*** Create Window 9 (Math sub-menu) ***/
-	UG_WindowCreate(&window_9, obj_buff_wnd_9, 6, window_9_callback);
+	UG_WindowCreate(&window_9, obj_buff_wnd_9, 10, window_9_callback);
 	UG_WindowSetStyle(&window_9, WND_STYLE_3D | WND_STYLE_HIDE_TITLE);
 	UG_WindowResize(&window_9, WIND9_X_START, WIND9_Y_START, WIND9_X_START + WIND9_WIDTH - 1, WIND9_Y_START + WIND9_HEIGHT - 1);
 	UG_WindowSetBackColor(&window_9, C_WHITE);
@@ -502,8 +742,28 @@ void initUI(void)
 	UG_ButtonSetBackColor(&window_9, BTN_ID_2, C_OLIVE);
 	UG_ButtonSetText(&window_9, BTN_ID_2, "0V");
 
+	UG_TextboxCreate(&window_9, &txtb9_3, TXB_ID_3, 1, 3*WIND9_BTN_HEIGHT + 3*WIND9_BTN_SPACING + 1, WIND9_BTN_WIDTH, 4*WIND9_BTN_HEIGHT + 3*WIND9_BTN_SPACING);	/* label */
+	UG_TextboxSetFont(&window_9, TXB_ID_3, &FONT_6X8);
+	UG_TextboxSetAlignment(&window_9, TXB_ID_3, ALIGN_CENTER_RIGHT);
+	UG_TextboxSetText(&window_9, TXB_ID_3, "Func:");
+
+	UG_TextboxCreate(&window_9, &txtb9_4, TXB_ID_4, 1, 4*WIND9_BTN_HEIGHT + 4*WIND9_BTN_SPACING + 1, WIND9_BTN_WIDTH, 5*WIND9_BTN_HEIGHT + 4*WIND9_BTN_SPACING);	/* label */
+	UG_TextboxSetFont(&window_9, TXB_ID_4, &FONT_6X8);
+	UG_TextboxSetAlignment(&window_9, TXB_ID_4, ALIGN_CENTER_RIGHT);
+	UG_TextboxSetText(&window_9, TXB_ID_4, "Filter:");
+
+	UG_ButtonCreate(&window_9, &button9_3, BTN_ID_3, 71, 3*WIND9_BTN_HEIGHT + 3*WIND9_BTN_SPACING + 1, 71 + WIND9_BTN_WIDTH - 1, 4*WIND9_BTN_HEIGHT + 3*WIND9_BTN_SPACING);	/* Function select */
+	UG_ButtonSetFont(&window_9, BTN_ID_3, &FONT_6X8);
+	UG_ButtonSetBackColor(&window_9, BTN_ID_3, C_OLIVE);
+	UG_ButtonSetText(&window_9, BTN_ID_3, mathFnTexts[MATH_FN_NONE]);
+
+	UG_ButtonCreate(&window_9, &button9_4, BTN_ID_4, 71, 4*WIND9_BTN_HEIGHT + 4*WIND9_BTN_SPACING + 1, 71 + WIND9_BTN_WIDTH - 1, 5*WIND9_BTN_HEIGHT + 4*WIND9_BTN_SPACING);	/* Low-pass filter select */
+	UG_ButtonSetFont(&window_9, BTN_ID_4, &FONT_6X8);
+	UG_ButtonSetBackColor(&window_9, BTN_ID_4, C_OLIVE);
+	UG_ButtonSetText(&window_9, BTN_ID_4, mathFiltTexts[MATH_FILT_OFF]);
+
 	/*** Create Window 10 (Cursors sub-menu) ***/
-	UG_WindowCreate(&window_10, obj_buff_wnd_10, 8, window_10_callback);
+	UG_WindowCreate(&window_10, obj_buff_wnd_10, 10, window_10_callback);
 	UG_WindowSetStyle(&window_10, WND_STYLE_3D | WND_STYLE_HIDE_TITLE);
 	UG_WindowResize(&window_10, WIND10_X_START, WIND10_Y_START, WIND10_X_START + WIND10_WIDTH - 1, WIND10_Y_START + WIND10_HEIGHT - 1);
 	UG_WindowSetBackColor(&window_10, C_WHITE);
@@ -534,6 +794,11 @@ void initUI(void)
 	UG_TextboxSetAlignment(&window_10, TXB_ID_4, ALIGN_CENTER);
 	UG_TextboxSetText(&window_10, TXB_ID_4, "--");
 
+	UG_TextboxCreate(&window_10, &txtb10_5, TXB_ID_5, 1, 4*WIND10_BTN_HEIGHT + 2*WIND10_BTN_SPACING1 + 2*WIND10_BTN_SPACING2 + 1, WIND10_BTN_WIDTH, 5*WIND10_BTN_HEIGHT + 2*WIND10_BTN_SPACING1 + 2*WIND10_BTN_SPACING2);	/* label */
+	UG_TextboxSetFont(&window_10, TXB_ID_5, &FONT_6X8);
+	UG_TextboxSetAlignment(&window_10, TXB_ID_5, ALIGN_CENTER_RIGHT);
+	UG_TextboxSetText(&window_10, TXB_ID_5, "Gate:");
+
 	UG_ButtonCreate(&window_10, &button10_0, BTN_ID_0, 71, 1, 71 + WIND10_BTN_WIDTH, WIND10_BTN_HEIGHT);		/* Cursor type */
 	UG_ButtonSetFont(&window_10, BTN_ID_0, &FONT_6X8);
 	UG_ButtonSetBackColor(&window_10, BTN_ID_0, C_OLIVE);
@@ -549,6 +814,11 @@ void initUI(void)
 	UG_ButtonSetBackColor(&window_10, BTN_ID_2, C_OLIVE);
 	UG_ButtonSetText(&window_10, BTN_ID_2, "--");
 
+	UG_ButtonCreate(&window_10, &button10_3, BTN_ID_3, 71, 4*WIND10_BTN_HEIGHT + 2*WIND10_BTN_SPACING1 + 2*WIND10_BTN_SPACING2 + 1, 71 + WIND10_BTN_WIDTH, 5*WIND10_BTN_HEIGHT + 2*WIND10_BTN_SPACING1 + 2*WIND10_BTN_SPACING2);	/* measurement gate */
+	UG_ButtonSetFont(&window_10, BTN_ID_3, &FONT_6X8);
+	UG_ButtonSetBackColor(&window_10, BTN_ID_3, C_OLIVE);
+	UG_ButtonSetText(&window_10, BTN_ID_3, "OFF");
+
 	/*** Create Window 11 (Info window) ***/
 	UG_WindowCreate(&window_11, obj_buff_wnd_11, 1, window_11_callback);
 	UG_WindowSetStyle(&window_11, WND_STYLE_3D | WND_STYLE_HIDE_TITLE);
@@ -559,75 +829,113 @@ void initUI(void)
 	UG_TextboxSetFont(&window_11, TXB_ID_0, &FONT_6X8);
 	UG_TextboxSetAlignment(&window_11, TXB_ID_0, ALIGN_CENTER);
 	UG_TextboxSetForeColor(&window_11, TXB_ID_0, C_RED);
+
+	/*** Create Window 12 (Spectrum peak table) ***/
+	UG_WindowCreate(&window_12, obj_buff_wnd_12, FFT_PEAKS_MAX, window_12_callback);
+	UG_WindowSetStyle(&window_12, WND_STYLE_2D | WND_STYLE_HIDE_TITLE);
+	UG_WindowResize(&window_12, WIND12_X_START, WIND12_Y_START, WIND12_X_START + WIND12_WIDTH - 1, WIND12_Y_START + WIND12_HEIGHT - 1);
+	UG_WindowSetBackColor(&window_12, C_WHITE);
+
+	UG_TextboxCreate(&window_12, &txtb12_0, TXB_ID_0, 2, 2, WIND12_WIDTH - 3, WIND12_LINE_HEIGHT + 1);		/* strongest peak */
+	UG_TextboxCreate(&window_12, &txtb12_1, TXB_ID_1, 2, WIND12_LINE_HEIGHT + 2, WIND12_WIDTH - 3, 2*WIND12_LINE_HEIGHT + 1);
+	UG_TextboxCreate(&window_12, &txtb12_2, TXB_ID_2, 2, 2*WIND12_LINE_HEIGHT + 2, WIND12_WIDTH - 3, 3*WIND12_LINE_HEIGHT + 1);
+	UG_TextboxCreate(&window_12, &txtb12_3, TXB_ID_3, 2, 3*WIND12_LINE_HEIGHT + 2, WIND12_WIDTH - 3, 4*WIND12_LINE_HEIGHT + 1);
+	UG_TextboxCreate(&window_12, &txtb12_4, TXB_ID_4, 2, 4*WIND12_LINE_HEIGHT + 2, WIND12_WIDTH - 3, 5*WIND12_LINE_HEIGHT + 1);
+	for(i = TXB_ID_0; i <= TXB_ID_4; i++){
+		UG_TextboxSetFont(&window_12, i, &FONT_6X8);
+		UG_TextboxSetAlignment(&window_12, i, ALIGN_CENTER_LEFT);
+		UG_TextboxSetText(&window_12, i, "");
+	}
 }
 
 /**
-  * @brief  Draw horizontal and vertical grid lines.
+  * @brief  Draw horizontal and vertical grid lines (and the channel separator in split mode).
   * @param  None
   * @retval None
   */
 void drawGrid(void)
 {
-	drawGridHoriz();
+	drawGridRect(0, MENUBAR_HEIGHT, LCD_WIDTH - 1, LCD_HEIGHT - MENUBAR_HEIGHT - 1);
+}
 
-	drawGridVerti();
+/**
+  * @brief  Restore the grid in a portion of the plot area from the pre-rendered grid surface
+  * 		of the current display mode.
+  * @param  x1: x start
+  * @param  y1: y start
+  * @param  x2: x end
+  * @param  y2: y end
+  * @retval None
+  */
+static void drawGridRect(UG_S16 x1, UG_S16 y1, UG_S16 x2, UG_S16 y2)
+{
+	overlayUGUI(chDispMode == CHDISPMODE_SPLIT ? GRID_SURFACE_SPLIT : GRID_SURFACE_MERGE, x1, y1, x2, y2);
+
+	/* windows drawn over the grid area need to be redrawn */
+	invalidateWindows(x1, y1, x2, y2);
 }
 
 /**
-  * @brief  Draw horizontal grid lines and channel separator.
+  * @brief  Draw vertical grid lines only (frequency divisions of the spectrum).
   * @param  None
   * @retval None
   */
-static void drawGridHoriz(void)
+static void drawGridVerti(void)
+{
+	overlayUGUI(GRID_SURFACE_FFT, 0, MENUBAR_HEIGHT, LCD_WIDTH - 1, LCD_HEIGHT - MENUBAR_HEIGHT - 1);
+
+	invalidateWindows(0, MENUBAR_HEIGHT, LCD_WIDTH - 1, LCD_HEIGHT - MENUBAR_HEIGHT - 1);
+}
+
+/**
+  * @brief  Render a grid variant into its ARGB1555 overlay surface. Pixels not part of
+  * 		the grid are left fully transparent.
+  * @param  addr: surface address
+  * @param  horiz: draw horizontal grid lines
+  * @param  separator: draw the separator between the two channels
+  * @retval None
+  */
+static void renderGridSurface(uint32_t addr, uint8_t horiz, uint8_t separator)
 {
-	__IO uint16_t (*pFrame)[LCD_WIDTH];
+	__IO uint16_t (*pSurf)[LCD_WIDTH] = (__IO uint16_t (*)[LCD_WIDTH])addr;
 	int32_t i, j;
 
-	pFrame = (uint16_t (*)[LCD_WIDTH])LCD_DRAW_BUFFER_UGUI;
+	for(i = 0; i < LCD_HEIGHT; i++)
+		for(j = 0; j < LCD_WIDTH; j++)
+			pSurf[i][j] = 0x0000;
 
-	/* Draw horizontal grid lines */
-	for(i = MENUBAR_HEIGHT; i < LCD_HEIGHT - MENUBAR_HEIGHT; i += (LCD_HEIGHT - 2*MENUBAR_HEIGHT)/GRID_VERT_DIVS){
-		for(j = 0; j < LCD_WIDTH; j += GRID_DOT_SPACING){
-				pFrame[i][j] = GRID_COLOR;
+	/* Horizontal grid lines */
+	if(horiz){
+		for(i = MENUBAR_HEIGHT; i < LCD_HEIGHT - MENUBAR_HEIGHT; i += (LCD_HEIGHT - 2*MENUBAR_HEIGHT)/GRID_VERT_DIVS){
+			for(j = 0; j < LCD_WIDTH; j += GRID_DOT_SPACING){
+				pSurf[i][j] = RGB565_TO_ARGB1555(GRID_COLOR);
 			}
+		}
 	}
 
-	if(chDispMode == CHDISPMODE_SPLIT){
-		/* Draw separator between the two channels */
+	/* Separator between the two channels */
+	if(separator){
 		i = CH_SEPARATOR_POS;
 		for(j = 0; j < LCD_WIDTH; j += 1){
-			pFrame[i][j] = CH_SEPARATOR_COLOR;
+			pSurf[i][j] = RGB565_TO_ARGB1555(CH_SEPARATOR_COLOR);
 		}
 	}
-}
-
-/**
-  * @brief  Draw vertical grid lines.
-  * @param  None
-  * @retval None
-  */
-static void drawGridVerti(void)
-{
-	__IO uint16_t (*pFrame)[LCD_WIDTH];
-	int32_t i, j;
 
-	pFrame = (uint16_t (*)[LCD_WIDTH])LCD_DRAW_BUFFER_UGUI;
-
-	/* Draw vertical grid lines */
+	/* Vertical grid lines */
 	for(j = LCD_WIDTH/GRID_HORZ_DIVS - 1; j < LCD_WIDTH - 1; j += LCD_WIDTH/GRID_HORZ_DIVS){
 		for(i = MENUBAR_HEIGHT; i < LCD_HEIGHT - MENUBAR_HEIGHT; i += GRID_DOT_SPACING){
-			pFrame[i][j] = GRID_COLOR;
+			pSurf[i][j] = RGB565_TO_ARGB1555(GRID_COLOR);
 		}
 	}
 }
 
 /**
-  * @brief  Convert a 8-bit ADC value to mV/V voltage constant-length string.
-  * @param  val: 8-bit ADC value
+  * @brief  Convert a (non-negative) ADC value to mV/V voltage constant-length string.
+  * @param  val: ADC value, up to 2*255 for math
   * @param  buf: output string of length 5
   * @retval None
   */
-void voltsToStr(uint8_t val, char* buf)
+void voltsToStr(uint16_t val, char* buf)
 {
 	float32_t volts;
 	char buf2[5];
@@ -663,6 +971,90 @@ void voltsToStr(uint8_t val, char* buf)
 	}
 }
 
+/**
+  * @brief  Display the spectrum marker frequency and the span center frequency.
+  * @param  None
+  * @retval None
+  */
+static void dispFFTFreqs(void)
+{
+	bufw8tb0[0] = '\0';
+	hertzToStr(spectrumFreq(toff)*samprateVals[tscale], bufw8tb0);
+	UG_TextboxSetText(&window_8, TXB_ID_0, bufw8tb0);
+
+	/* the center the next zoom will use, when not zoomed */
+	bufw7btn3[0] = '\0';
+	hertzToStr((fftZoom ? spectrumFreq(LCD_WIDTH/2) : fftCenter)*samprateVals[tscale], bufw7btn3);
+	UG_ButtonSetText(&window_7, BTN_ID_3, bufw7btn3);
+}
+
+/**
+  * @brief  Display the spectrum engine and the time the last spectrum took, e.g. "F 1234us"
+  * 		(max. 9 chars, to fit the button).
+  * @param  None
+  * @retval None
+  */
+static void dispFFTEngine(void)
+{
+	uint32_t t;
+
+	if(spectrumCycles){
+		strcpy(bufw7btn7, (fftEngine == FFTENGINE_Q15) ? "Q " : "F ");
+		t = spectrumCycles/(SystemCoreClock/1000000);
+		if(t < 10000){
+			itoa(t, bufw7btn7 + strlen(bufw7btn7), 10);
+			strcat(bufw7btn7, "us");
+		}
+		else{
+			itoa(t/1000, bufw7btn7 + strlen(bufw7btn7), 10);
+			strcat(bufw7btn7, "ms");
+		}
+	}
+	else{
+		strcpy(bufw7btn7, (fftEngine == FFTENGINE_Q15) ? "Q15" : "Float");
+	}
+	UG_ButtonSetText(&window_7, BTN_ID_7, bufw7btn7);
+}
+
+/**
+  * @brief  Display the spectrum peak table, shown only over the spectrum view.
+  * @param  None
+  * @retval None
+  */
+static void dispFFTPeaks(void)
+{
+	uint8_t show;
+	uint32_t i;
+
+	show = (fftPeaks != FFTPEAKS_OFF && chDispMode == CHDISPMODE_FFT && fftView == FFTVIEW_SPECTRUM);
+
+	if(!show){
+		if(showWindow12){
+			showWindow12 = 0;
+			fillFrameUGUI(WIND12_X_START, WIND12_Y_START, WIND12_X_START + WIND12_WIDTH - 1, WIND12_Y_START + WIND12_HEIGHT - 1, C_BLACK);
+			drawGrid();
+		}
+		return;
+	}
+
+	/* <no.> <freq> <level>, strongest first */
+	for(i = 0; i < FFT_PEAKS_MAX; i++){
+		bufw12tb[i][0] = '\0';
+		if(i < spectrumPeakCnt){
+			bufw12tb[i][0] = '1' + i;
+			bufw12tb[i][1] = ' ';
+			bufw12tb[i][2] = '\0';
+			hertzToStr(spectrumPeaks[i].freq*samprateVals[tscale], bufw12tb[i]);
+			strcat(bufw12tb[i], " ");
+			itoa(spectrumPeaks[i].level + 0.5f, bufw12tb[i] + strlen(bufw12tb[i]), 10);
+			strcat(bufw12tb[i], "dB");
+		}
+		UG_TextboxSetText(&window_12, TXB_ID_0 + i, bufw12tb[i]);
+	}
+
+	showWindow12 = 1;
+}
+
 /**
   * @brief  Convert a frequency value to Hz/KHz constant-length string.
   * @param  freq: frequency to display
@@ -749,6 +1141,47 @@ void secToStr(float32_t t, char* buf)
 	}
 }
 
+/**
+  * @brief  Convert a channel sample to its row in the Wave draw buffer, as per the channel's
+  * 		vertical scale/offset and the display mode. Math is always drawn over the whole screen.
+  * @param  val: sample value
+  * @param  ch: channel (1 or 2, 3 for math)
+  * @retval Row in the Wave draw buffer
+  */
+int32_t sampleToRow(int32_t val, uint8_t ch)
+{
+	if(chDispMode == CHDISPMODE_SPLIT && ch != CHANNELMATH)
+		return sampleToRowArea(val, ch, (ch == 1) ? CHDISPMODE_SPLIT_CH1BOT : CHDISPMODE_SPLIT_CH2BOT, CHDISPMODE_SPLIT_SIGMAX);
+	else
+		return sampleToRowArea(val, ch, CHDISPMODE_MERGE_CHBOT, CHDISPMODE_MERGE_SIGMAX);
+}
+
+/**
+  * @brief  Convert a channel sample to its row in a given area of the Wave draw buffer, as per
+  * 		the channel's vertical scale/offset.
+  * @param  val: sample value
+  * @param  ch: channel (1 or 2, 3 for math)
+  * @param  bot: bottom row of the area
+  * @param  sigmax: max. signal height in the area
+  * @retval Row in the Wave draw buffer
+  */
+int32_t sampleToRowArea(int32_t val, uint8_t ch, int32_t bot, int32_t sigmax)
+{
+	int32_t temp;
+
+	if(ch == 1)
+		temp = (float32_t)(voff1 + val)/vscaleVals[vscale1];
+	else if(ch == 2)
+		temp = (float32_t)(voff2 + val)/vscaleVals[vscale2];
+	else
+		temp = (float32_t)(mathVoff + MATH_LSB*(val - MATH_ZERO))/vscaleVals[mathVscale];
+
+	if(temp > sigmax)	temp = sigmax;
+	if(temp < 0)  temp = 0;
+
+	return bot - temp;
+}
+
 /* Callback function for window 1 (top menubar) */
 static void window_1_callback(UG_MESSAGE* msg)
 {
@@ -836,8 +1269,9 @@ static void window_3_callback(UG_MESSAGE* msg)
 					if((showWindow5 == 0) || (wind5OpenedBy != MEASURE1)){
 						showWindow5 = 1;			/* show submenu */
 						wind5OpenedBy = MEASURE1;
-						UG_ButtonSetText(&window_5, BTN_ID_0, (measure1.src == CHANNEL1) ? "CH1" : "CH2");
+						UG_ButtonSetText(&window_5, BTN_ID_0, measSrcTexts[measure1.src]);
 						UG_ButtonSetText(&window_5, BTN_ID_1, measParamTexts[measure1.param]);
+						DisplayMeasStats();
 					}
 					else{
 						showWindow5 = 0;			/* close submenu */
@@ -852,8 +1286,9 @@ static void window_3_callback(UG_MESSAGE* msg)
 					if((showWindow5 == 0) || (wind5OpenedBy != MEASURE2)){
 						showWindow5 = 1;			/* show submenu */
 						wind5OpenedBy = MEASURE2;
-						UG_ButtonSetText(&window_5, BTN_ID_0, (measure2.src == CHANNEL1) ? "CH1" : "CH2");
+						UG_ButtonSetText(&window_5, BTN_ID_0, measSrcTexts[measure2.src]);
 						UG_ButtonSetText(&window_5, BTN_ID_1, measParamTexts[measure2.param]);
+						DisplayMeasStats();
 					}
 					else{
 						showWindow5 = 0;			/* close submenu */
@@ -868,8 +1303,9 @@ static void window_3_callback(UG_MESSAGE* msg)
 					if((showWindow5 == 0) || (wind5OpenedBy != MEASURE3)){
 						showWindow5 = 1;			/* show submenu */
 						wind5OpenedBy = MEASURE3;
-						UG_ButtonSetText(&window_5, BTN_ID_0, (measure3.src == CHANNEL1) ? "CH1" : "CH2");
+						UG_ButtonSetText(&window_5, BTN_ID_0, measSrcTexts[measure3.src]);
 						UG_ButtonSetText(&window_5, BTN_ID_1, measParamTexts[measure3.param]);
+						DisplayMeasStats();
 					}
 					else{
 						showWindow5 = 0;			/* close submenu */
@@ -884,8 +1320,9 @@ static void window_3_callback(UG_MESSAGE* msg)
 					if((showWindow5 == 0) || (wind5OpenedBy != MEASURE4)){
 						showWindow5 = 1;			/* show submenu */
 						wind5OpenedBy = MEASURE4;
-						UG_ButtonSetText(&window_5, BTN_ID_0, (measure4.src == CHANNEL1) ? "CH1" : "CH2");
+						UG_ButtonSetText(&window_5, BTN_ID_0, measSrcTexts[measure4.src]);
 						UG_ButtonSetText(&window_5, BTN_ID_1, measParamTexts[measure4.param]);
+						DisplayMeasStats();
 					}
 					else{
 						showWindow5 = 0;			/* close submenu */
@@ -943,28 +1380,51 @@ static void window_5_callback(UG_MESSAGE* msg)
 			 switch(msg->sub_id)
 			 {
 				 /* measure source button */
-			 	 case BTN_ID_0:							/* toggle channel */
+			 	 case BTN_ID_0:							/* next channel, math only when it is on */
 			 		 if(measPtr->src == CHANNEL1)
 			 			measPtr->src = CHANNEL2;
+			 		 else if(measPtr->src == CHANNEL2 && mathOp != MATH_OP_NONE)
+			 			measPtr->src = CHANNELMATH;
 			 		 else
 						measPtr->src = CHANNEL1;
+			 		 resetMeasStats(measPtr);
 			 		 break;
 
 				 /* measure param button */
 				 case BTN_ID_1:							/* select next measure parameter */
-					 if(measPtr->param == MEAS_VAVG)
+					 if(measPtr->param == MEAS_LAST)
 						 measPtr->param = MEAS_NONE;
 					 else
 						 measPtr->param = measPtr->param + 1;
+					 resetMeasStats(measPtr);
+					 break;
+
+				 /* statistics on/off button, applies to all measurements */
+				 case BTN_ID_2:
+					 measStatsOn = !measStatsOn;
+					 break;
+
+				 /* statistics reset button */
+				 case BTN_ID_3:
+					 resetMeasStats(measPtr);
+					 break;
+
+				 /* highest harmonic summed into THD, applies to all measurements */
+				 case BTN_ID_4:
+					 measHarmonics = (measHarmonics == MEAS_HARMONICS_MAX) ? 2 : measHarmonics + 1;
+					 itoa(measHarmonics, bufw5btn4, 10);
+					 UG_ButtonSetText(&window_5, BTN_ID_4, bufw5btn4);
 					 break;
 			 }
 
 			 /* update button text and colors according to chosen setting */
-			 UG_ButtonSetText(&window_5, BTN_ID_0, (measPtr->src == CHANNEL1) ? "CH1" : "CH2");
+			 UG_ButtonSetText(&window_5, BTN_ID_0, measSrcTexts[measPtr->src]);
 			 UG_ButtonSetText(&window_5, BTN_ID_1, measParamTexts[measPtr->param]);
 
-			 UG_ButtonSetBackColor(&window_3, wind3BtnID, (measPtr->param == MEAS_NONE) ? INACTIVE_ICON_COLOR : ((measPtr->src == CHANNEL1) ? CH1_COLOR : CH2_COLOR));
+			 UG_ButtonSetBackColor(&window_3, wind3BtnID, (measPtr->param == MEAS_NONE) ? INACTIVE_ICON_COLOR : measSrcColors[measPtr->src]);
 			 UG_ButtonSetText(&window_3, wind3BtnID, measParamTexts[measPtr->param]);
+
+			 DisplayMeasStats();
 		  }
 	  }
 	}
@@ -1081,6 +1541,8 @@ static void window_6_callback(UG_MESSAGE* msg)
 	__IO uint16_t (*pFrame)[LCD_WIDTH] = (uint16_t (*)[LCD_WIDTH])LCD_DRAW_BUFFER_UGUI;
 	int32_t i, j;
 
+	DMA2D_waitBuffer(LCD_DRAW_BUFFER_UGUI);
+
 	if (msg->type == MSG_TYPE_OBJECT)
 	{
 	  if (msg->id == OBJ_TYPE_BUTTON)
@@ -1092,8 +1554,15 @@ static void window_6_callback(UG_MESSAGE* msg)
 			 	 /* change display mode */
 			 	 case BTN_ID_0:
 			 		if(chDispMode != CHDISPMODE_FFT && mathOp == MATH_OP_NONE && cursorMode == CURSOR_MODE_OFF){
-						chDispMode = (chDispMode + 1) % 3;
-						UG_ButtonSetText(&window_6, BTN_ID_0, chDispMode == CHDISPMODE_SPLIT ? "Split" : (chDispMode == CHDISPMODE_MERGE ? "Merge" : "Single"));
+						/* Split -> Merge -> Single -> XY -> Split */
+						if(chDispMode == CHDISPMODE_SNGL)
+							chDispMode = CHDISPMODE_XY;
+						else if(chDispMode == CHDISPMODE_XY)
+							chDispMode = CHDISPMODE_SPLIT;
+						else
+							chDispMode++;
+						UG_ButtonSetText(&window_6, BTN_ID_0, chDispMode == CHDISPMODE_SPLIT ? "Split" : (chDispMode == CHDISPMODE_MERGE ? "Merge" :
+											(chDispMode == CHDISPMODE_SNGL ? "Single" : "XY")));
 
 						if(chDispMode != CHDISPMODE_SPLIT){
 							/* Erase separator between the two channels */
@@ -1101,6 +1570,7 @@ static void window_6_callback(UG_MESSAGE* msg)
 							for(j = 0; j < LCD_WIDTH; j += 1){
 								pFrame[i][j] = C_BLACK;
 							}
+							invalidateWindows(0, CH_SEPARATOR_POS, LCD_WIDTH - 1, CH_SEPARATOR_POS);
 
 							drawGrid();
 						}
@@ -1116,6 +1586,25 @@ static void window_6_callback(UG_MESSAGE* msg)
 						changeFieldValue(2);
 			 		}
 			 		break;
+
+			 	 /* XY persistence on/off */
+			 	 case BTN_ID_1:
+			 		xyPersist = !xyPersist;
+			 		UG_ButtonSetText(&window_6, BTN_ID_1, xyPersist ? "ON" : "OFF");
+			 		break;
+
+			 	 /* XY dots/connected segments */
+			 	 case BTN_ID_2:
+			 		xyLines = !xyLines;
+			 		UG_ButtonSetText(&window_6, BTN_ID_2, xyLines ? "Lines" : "Dots");
+			 		break;
+
+			 	 /* static mode zoom: overview + magnified view/full screen */
+			 	 case BTN_ID_3:
+			 		stmZoomView = !stmZoomView;
+			 		UG_ButtonSetText(&window_6, BTN_ID_3, stmZoomView ? "Split" : "Full");
+			 		toffChanged = 1;		/* redraw if in static mode */
+			 		break;
 			 }
 		  }
 	  }
@@ -1128,6 +1617,8 @@ static void window_7_callback(UG_MESSAGE* msg)
 	__IO uint16_t (*pFrame)[LCD_WIDTH] = (uint16_t (*)[LCD_WIDTH])LCD_DRAW_BUFFER_UGUI;
 	int32_t i, j;
 
+	DMA2D_waitBuffer(LCD_DRAW_BUFFER_UGUI);
+
 	if (msg->type == MSG_TYPE_OBJECT)
 	{
 	  if (msg->id == OBJ_TYPE_BUTTON)
@@ -1138,8 +1629,10 @@ static void window_7_callback(UG_MESSAGE* msg)
 			 {
 			 	 /* change FFT source channel */
 			 	 case BTN_ID_0:
-					fftSrcChannel = (fftSrcChannel + 1) % 3;
-					UG_ButtonSetText(&window_7, BTN_ID_0, fftSrcChannel == CHANNEL1 ? "CH1" : (fftSrcChannel == CHANNEL2 ? "CH2" : "OFF"));
+					fftSrcChannel = (fftSrcChannel + 1) % 4;
+					if(fftSrcChannel == CHANNELMATH && mathOp == MATH_OP_NONE)
+						fftSrcChannel = CHANNELNONE;		/* math only when it is on */
+					UG_ButtonSetText(&window_7, BTN_ID_0, fftSrcChannel == CHANNEL1 ? "CH1" : (fftSrcChannel == CHANNEL2 ? "CH2" : (fftSrcChannel == CHANNELMATH ? "Math" : "OFF")));
 
 					if(fftSrcChannel != CHANNELNONE){
 						chDispMode = CHDISPMODE_FFT;
@@ -1149,10 +1642,9 @@ static void window_7_callback(UG_MESSAGE* msg)
 						for(j = 0; j < LCD_WIDTH; j += 1){
 							pFrame[i][j] = C_BLACK;
 						}
+						invalidateWindows(0, CH_SEPARATOR_POS, LCD_WIDTH - 1, CH_SEPARATOR_POS);
 
-						bufw8tb0[0] = '\0';		/* update frequency display value */
-						hertzToStr(0.5f*toff*samprateVals[tscale]/(float32_t)LCD_WIDTH, bufw8tb0);
-						UG_TextboxSetText(&window_8, TXB_ID_0, bufw8tb0);
+						dispFFTFreqs();			/* update frequency display values */
 						showWindow8 = 1;		/* show sub-submenu */
 						drawGridVerti();
 					}
@@ -1167,11 +1659,65 @@ static void window_7_callback(UG_MESSAGE* msg)
 						fillFrameUGUI(xs, WIND8_Y_START, xs + WIND8_WIDTH - 1, WIND8_Y_START + WIND8_HEIGHT - 1, C_BLACK);
 						drawGrid();
 					}
+					dispFFTPeaks();				/* the peak table goes with the spectrum */
 
 					/* force the cursors to be redrawn */
 					goToField(FLD_NONE);
 					changeFieldValue(2);
 			 		break;
+
+			 	 /* change spectrum view */
+			 	 case BTN_ID_1:
+			 		fftView = (fftView == FFTVIEW_SPECTRUM) ? FFTVIEW_WFALL : FFTVIEW_SPECTRUM;
+			 		UG_ButtonSetText(&window_7, BTN_ID_1, fftView == FFTVIEW_SPECTRUM ? "Spectrum" : "Waterfall");
+			 		dispFFTPeaks();			/* no peak table over the waterfall */
+			 		break;
+
+			 	 /* change spectrum span */
+			 	 case BTN_ID_2:
+			 		fftZoom = (fftZoom + 1) % (FFT_ZOOM_MAX + 1);
+			 		UG_ButtonSetText(&window_7, BTN_ID_2, fftSpanTexts[fftZoom]);
+			 		dispFFTFreqs();
+			 		break;
+
+			 	 /* center the span on the marker frequency */
+			 	 case BTN_ID_3:
+			 		fftCenter = spectrumFreq(toff);
+			 		dispFFTFreqs();
+			 		break;
+
+			 	 /* change spectrum window */
+			 	 case BTN_ID_4:
+			 		fftWindow = (fftWindow + 1) % FFTWIN_NUM;
+			 		UG_ButtonSetText(&window_7, BTN_ID_4, fftWindowTexts[fftWindow]);
+			 		break;
+
+			 	 /* change no. of frames averaged */
+			 	 case BTN_ID_5:
+			 		fftAvg = (fftAvg + 1) % (FFT_AVG_MAX + 1);
+			 		UG_ButtonSetText(&window_7, BTN_ID_5, fftAvgTexts[fftAvg]);
+			 		break;
+
+			 	 /* change hold traces */
+			 	 case BTN_ID_6:
+			 		fftHold = (fftHold + 1) % 4;
+			 		UG_ButtonSetText(&window_7, BTN_ID_6, fftHoldTexts[fftHold]);
+			 		break;
+
+			 	 /* change spectrum engine */
+			 	 case BTN_ID_7:
+			 		fftEngine = (fftEngine == FFTENGINE_FLOAT) ? FFTENGINE_Q15 : FFTENGINE_FLOAT;
+			 		spectrumCycles = 0;
+			 		dispFFTEngine();
+			 		break;
+
+			 	 /* change peak table/harmonic markers */
+			 	 case BTN_ID_8:
+			 		fftPeaks = (fftPeaks + 1) % 3;
+			 		spectrumPeakCnt = 0;
+			 		UG_ButtonSetText(&window_7, BTN_ID_8, fftPeaksTexts[fftPeaks]);
+			 		dispFFTPeaks();
+			 		break;
 			 }
 		  }
 	  }
@@ -1190,6 +1736,8 @@ static void window_9_callback(UG_MESSAGE* msg)
 	__IO uint16_t (*pFrame)[LCD_WIDTH] = (uint16_t (*)[LCD_WIDTH])LCD_DRAW_BUFFER_UGUI;
 	int32_t i, j;
 
+	DMA2D_waitBuffer(LCD_DRAW_BUFFER_UGUI);
+
 	if (msg->type == MSG_TYPE_OBJECT)
 	{
 	  if (msg->id == OBJ_TYPE_BUTTON)
@@ -1200,17 +1748,41 @@ static void window_9_callback(UG_MESSAGE* msg)
 			 {
 			 	 /* change math operation */
 			 	 case BTN_ID_0:
-					mathOp = (mathOp + 1) % 5;
-					if(mathOp == MATH_OP_NONE)
-						UG_ButtonSetText(&window_9, BTN_ID_0, "OFF");
-					else if(mathOp == MATH_OP_1P2)
-						UG_ButtonSetText(&window_9, BTN_ID_0, "1 + 2");
-					else if(mathOp == MATH_OP_1M2)
-						UG_ButtonSetText(&window_9, BTN_ID_0, "1 - 2");
-					else if(mathOp == MATH_OP_2M1)
-						UG_ButtonSetText(&window_9, BTN_ID_0, "2 - 1");
-					else
-						UG_ButtonSetText(&window_9, BTN_ID_0, "1 x 2");
+					mathOp = (mathOp + 1) % MATH_OP_NUM;
+					UG_ButtonSetText(&window_9, BTN_ID_0, mathOpTexts[mathOp]);
+					mathChanged = 1;
+
+					/* the spectrum of the math waveform goes off with it */
+					if(mathOp == MATH_OP_NONE && fftSrcChannel == CHANNELMATH){
+						UG_S16 xs;
+
+						fftSrcChannel = CHANNELNONE;
+						UG_ButtonSetText(&window_7, BTN_ID_0, "OFF");
+
+						showWindow8 = 0;		/* close FFT sub-submenu */
+						xs = UG_WindowGetXStart(&window_8);
+						fillFrameUGUI(xs, WIND8_Y_START, xs + WIND8_WIDTH - 1, WIND8_Y_START + WIND8_HEIGHT - 1, C_BLACK);
+					}
+
+					/* as do the measurements of it, back to CH1 */
+					if(mathOp == MATH_OP_NONE){
+						Measure_TypeDef* meas[4] = {&measure1, &measure2, &measure3, &measure4};
+
+						for(i = 0; i < 4; i++){
+							if(meas[i]->src != CHANNELMATH)
+								continue;
+
+							meas[i]->src = CHANNEL1;
+							resetMeasStats(meas[i]);
+							if(meas[i]->param != MEAS_NONE)
+								UG_ButtonSetBackColor(&window_3, BTN_ID_0 + i, measSrcColors[CHANNEL1]);
+						}
+
+						if(showWindow5 && wind5OpenedBy != MEASURE_NONE){
+							UG_ButtonSetText(&window_5, BTN_ID_0, measSrcTexts[meas[wind5OpenedBy - 1]->src]);
+							DisplayMeasStats();
+						}
+					}
 
 					if(mathOp != MATH_OP_NONE){
 						/* Erase separator between the two channels */
@@ -1218,6 +1790,7 @@ static void window_9_callback(UG_MESSAGE* msg)
 						for(j = 0; j < LCD_WIDTH; j += 1){
 							pFrame[i][j] = C_BLACK;
 						}
+						invalidateWindows(0, CH_SEPARATOR_POS, LCD_WIDTH - 1, CH_SEPARATOR_POS);
 
 						chDispMode = CHDISPMODE_MERGE;
 						UG_ButtonSetText(&window_6, BTN_ID_0, "Merge");
@@ -1242,6 +1815,7 @@ static void window_9_callback(UG_MESSAGE* msg)
 
 						drawGrid();
 					}
+					dispFFTPeaks();				/* either way the display mode is no longer FFT */
 
 					/* force the cursors to be redrawn */
 					goToField(FLD_NONE);
@@ -1267,6 +1841,20 @@ static void window_9_callback(UG_MESSAGE* msg)
 						UG_ButtonSetFont(&window_9, BTN_ID_2, &FONT_7X12);	/* highlight offset field */
 					}
 					break;
+
+				 /* change function */
+				 case BTN_ID_3:
+					mathFn = (mathFn + 1) % MATH_FN_NUM;
+					UG_ButtonSetText(&window_9, BTN_ID_3, mathFnTexts[mathFn]);
+					mathChanged = 1;
+					break;
+
+				 /* change low-pass filter */
+				 case BTN_ID_4:
+					mathFilt = (mathFilt + 1) % (MATH_FILT_MAX + 1);
+					UG_ButtonSetText(&window_9, BTN_ID_4, mathFiltTexts[mathFilt]);
+					mathChanged = 1;
+					break;
 			 }
 		  }
 	  }
@@ -1359,6 +1947,13 @@ static void window_10_callback(UG_MESSAGE* msg)
 						UG_ButtonSetFont(&window_10, BTN_ID_2, &FONT_7X12);	/* highlight cursor B field */
 					}
 					break;
+
+				 /* measure only between the dT cursors */
+				 case BTN_ID_3:
+					cursorGate = !cursorGate;
+					UG_ButtonSetText(&window_10, BTN_ID_3, cursorGate ? "ON" : "OFF");
+					setMeasGate(cursorGate && cursorMode == CURSOR_MODE_DT, cursorApos, cursorBpos);
+					break;
 			 }
 		  }
 	  }
@@ -1371,70 +1966,85 @@ static void window_11_callback(UG_MESSAGE* msg)
 	/* Nothing to do */
 }
 
+/* Callback function for window 12 (Spectrum peak table) */
+static void window_12_callback(UG_MESSAGE* msg)
+{
+	/* Nothing to do */
+}
+
 /**
-  * @brief  Cycles through all the visible windows, displaying them one at a time.
+  * @brief  Compositor: draws all the visible windows in a single pass. A window which is
+  * 		newly shown or was damaged (see invalidateWindows()) is redrawn completely, any
+  * 		other window only gets its changed objects redrawn. Touch input and events are
+  * 		processed for every visible window.
   * @param  None
   * @retval None
   */
-void switchNextWindow(void)
+void updateWindows(void)
 {
-	static uint8_t currWind = WINDOW1;
-	uint8_t done = 0;
-
-	if(!done && currWind == WINDOW1){
-		UG_WindowShow(&window_2);	/* bottom menubar */
-		currWind = WINDOW2;
-		done = 1;
-	}
-	if(!done && currWind <= WINDOW2 && showWindow3){
-		UG_WindowShow(&window_3);	/* menu page 1 */
-		currWind = WINDOW3;
-		done = 1;
-	}
-	if(!done && currWind <= WINDOW3 && showWindow4){
-		UG_WindowShow(&window_4);
-		currWind = WINDOW4;
-		done = 1;
-	}
-	if(!done && currWind <= WINDOW4 && showWindow5){
-		UG_WindowShow(&window_5);
-		currWind = WINDOW5;
-		done = 1;
-	}
-	if(!done && currWind <= WINDOW5 && showWindow6){
-		UG_WindowShow(&window_6);
-		currWind = WINDOW6;
-		done = 1;
-	}
-	if(!done && currWind <= WINDOW6 && showWindow7){
-		UG_WindowShow(&window_7);
-		currWind = WINDOW7;
-		done = 1;
-	}
-	if(!done && currWind <= WINDOW7 && showWindow8){
-		UG_WindowShow(&window_8);
-		currWind = WINDOW8;
-		done = 1;
-	}
-	if(!done && currWind <= WINDOW8 && showWindow9){
-		UG_WindowShow(&window_9);
-		currWind = WINDOW9;
-		done = 1;
-	}
-	if(!done && currWind <= WINDOW9 && showWindow10){
-		UG_WindowShow(&window_10);
-		currWind = WINDOW10;
-		done = 1;
-	}
-	if(!done){
-		UG_WindowShow(&window_1);
-		currWind = WINDOW1;
-		done = 1;
+	uint8_t show[NUM_UI_WINDOWS];
+	int32_t i;
+
+	show[SLOT_WINDOW1] = 1;			/* top and bottom menubars are always shown */
+	show[SLOT_WINDOW2] = 1;
+	show[SLOT_WINDOW3] = showWindow3;
+	show[SLOT_WINDOW4] = showWindow4;
+	show[SLOT_WINDOW5] = showWindow5;
+	show[SLOT_WINDOW6] = showWindow6;
+	show[SLOT_WINDOW7] = showWindow7;
+	show[SLOT_WINDOW8] = showWindow8;
+	show[SLOT_WINDOW9] = showWindow9;
+	show[SLOT_WINDOW10] = showWindow10;
+	show[SLOT_WINDOW12] = showWindow12;
+
+	for(i = 0; i < NUM_UI_WINDOWS; i++){
+		UG_WindowSetVisible(uiWindows[i], show[i]);
+		if(show[i])
+			UG_WindowUpdate(uiWindows[i]);
 	}
 
 	return;
 }
 
+/**
+  * @brief  Marks the visible windows overlapping the given (damaged) rectangle of the uGUI
+  * 		draw buffer to be redrawn in the next compositor pass.
+  * @param  xs: x start
+  * @param  ys: y start
+  * @param  xe: x end
+  * @param  ye: y end
+  * @retval None
+  */
+void invalidateWindows(UG_S16 xs, UG_S16 ys, UG_S16 xe, UG_S16 ye)
+{
+	int32_t i;
+
+	for(i = 0; i < NUM_UI_WINDOWS; i++){
+		if(xe < UG_WindowGetXStart(uiWindows[i]) || xs > UG_WindowGetXEnd(uiWindows[i]) ||
+				ye < UG_WindowGetYStart(uiWindows[i]) || ys > UG_WindowGetYEnd(uiWindows[i]))
+			continue;
+
+		UG_WindowInvalidate(uiWindows[i]);
+	}
+}
+
+/**
+  * @brief  Marks the windows crossed by the measurement cursor lines to be redrawn.
+  * @param  None
+  * @retval None
+  */
+static void invalidateCursorLines(void)
+{
+	if(cursorMode == CURSOR_MODE_DT){
+		invalidateWindows(cursorApos, CHDISPMODE_MERGE_CHTOP, cursorApos, CHDISPMODE_MERGE_CHBOT);
+		invalidateWindows(cursorBpos, CHDISPMODE_MERGE_CHTOP, cursorBpos, CHDISPMODE_MERGE_CHBOT);
+	}
+	else{
+		invalidateWindows(0, cursorApos, LCD_WIDTH - 1, cursorApos);
+		invalidateWindows(0, cursorBpos, LCD_WIDTH - 1, cursorBpos);
+	}
+}
+
 /**
   * @brief  Clear the open window 4 submenu.
   * @param  None
@@ -1461,26 +2071,12 @@ void clearWind4Submenus(void)
   */
 void DisplayMeasurements(void)
 {
-	static char buf1[11], buf2[11], buf3[11], buf4[11];
+	static char buf1[12], buf2[12], buf3[12], buf4[12];		/* 10 chars, 11 for a negative math voltage */
 
 	/* measurement 1 */
 	if(measure1.param != MEAS_NONE){
-		if(measure1.param == MEAS_FREQ){
-			strcpy(buf1, "F:");
-			hertzToStr(calcMeasure(measure1.src, MEAS_FREQ) * samprateVals[tscale], buf1 + 2);
-		}
-		else if(measure1.param == MEAS_DUTY){
-			strcpy(buf1, measParamTexts[measure1.param]);
-			strcat(buf1, ":");
-			itoa(calcMeasure(measure1.src, measure1.param), buf1 + 5, 10);
-			strcat(buf1, "%");
-		}
-		else{
-			strcpy(buf1, measParamTexts[measure1.param]);
-			strcat(buf1, ":");
-			voltsToStr(calcMeasure(measure1.src, measure1.param), buf1 + 5);
-		}
-		UG_TextboxSetBackColor(&window_2, TXB_ID_3, (measure1.src == CHANNEL1) ? CH1_COLOR : CH2_COLOR);
+		measToStr(&measure1, buf1);
+		UG_TextboxSetBackColor(&window_2, TXB_ID_3, measSrcColors[measure1.src]);
 		UG_TextboxSetText(&window_2, TXB_ID_3, buf1);
 	}
 	else{
@@ -1490,22 +2086,8 @@ void DisplayMeasurements(void)
 
 	/* measurement 2 */
 	if(measure2.param != MEAS_NONE){
-		if(measure2.param == MEAS_FREQ){
-			strcpy(buf2, "F:");
-			hertzToStr(calcMeasure(measure2.src, MEAS_FREQ) * samprateVals[tscale], buf2 + 2);
-		}
-		else if(measure2.param == MEAS_DUTY){
-			strcpy(buf2, measParamTexts[measure2.param]);
-			strcat(buf2, ":");
-			itoa(calcMeasure(measure2.src, measure2.param), buf2 + 5, 10);
-			strcat(buf2, "%");
-		}
-		else{
-			strcpy(buf2, measParamTexts[measure2.param]);
-			strcat(buf2, ":");
-			voltsToStr(calcMeasure(measure2.src, measure2.param), buf2 + 5);
-		}
-		UG_TextboxSetBackColor(&window_2, TXB_ID_4, (measure2.src == CHANNEL1) ? CH1_COLOR : CH2_COLOR);
+		measToStr(&measure2, buf2);
+		UG_TextboxSetBackColor(&window_2, TXB_ID_4, measSrcColors[measure2.src]);
 		UG_TextboxSetText(&window_2, TXB_ID_4, buf2);
 	}
 	else{
@@ -1515,22 +2097,8 @@ void DisplayMeasurements(void)
 
 	/* measurement 3 */
 	if(measure3.param != MEAS_NONE){
-		if(measure3.param == MEAS_FREQ){
-			strcpy(buf3, "F:");
-			hertzToStr(calcMeasure(measure3.src, MEAS_FREQ) * samprateVals[tscale], buf3 + 2);
-		}
-		else if(measure3.param == MEAS_DUTY){
-			strcpy(buf3, measParamTexts[measure3.param]);
-			strcat(buf3, ":");
-			itoa(calcMeasure(measure3.src, measure3.param), buf3 + 5, 10);
-			strcat(buf3, "%");
-		}
-		else{
-			strcpy(buf3, measParamTexts[measure3.param]);
-			strcat(buf3, ":");
-			voltsToStr(calcMeasure(measure3.src, measure3.param), buf3 + 5);
-		}
-		UG_TextboxSetBackColor(&window_2, TXB_ID_5, (measure3.src == CHANNEL1) ? CH1_COLOR : CH2_COLOR);
+		measToStr(&measure3, buf3);
+		UG_TextboxSetBackColor(&window_2, TXB_ID_5, measSrcColors[measure3.src]);
 		UG_TextboxSetText(&window_2, TXB_ID_5, buf3);
 	}
 	else{
@@ -1540,22 +2108,8 @@ void DisplayMeasurements(void)
 
 	/* measurement 4 */
 	if(measure4.param != MEAS_NONE){
-		if(measure4.param == MEAS_FREQ){
-			strcpy(buf4, "F:");
-			hertzToStr(calcMeasure(measure4.src, MEAS_FREQ) * samprateVals[tscale], buf4 + 2);
-		}
-		else if(measure4.param == MEAS_DUTY){
-			strcpy(buf4, measParamTexts[measure4.param]);
-			strcat(buf4, ":");
-			itoa(calcMeasure(measure4.src, measure4.param), buf4 + 5, 10);
-			strcat(buf4, "%");
-		}
-		else{
-			strcpy(buf4, measParamTexts[measure4.param]);
-			strcat(buf4, ":");
-			voltsToStr(calcMeasure(measure4.src, measure4.param), buf4 + 5);
-		}
-		UG_TextboxSetBackColor(&window_2, TXB_ID_6, (measure4.src == CHANNEL1) ? CH1_COLOR : CH2_COLOR);
+		measToStr(&measure4, buf4);
+		UG_TextboxSetBackColor(&window_2, TXB_ID_6, measSrcColors[measure4.src]);
 		UG_TextboxSetText(&window_2, TXB_ID_6, buf4);
 	}
 	else{
@@ -1563,9 +2117,148 @@ void DisplayMeasurements(void)
 		UG_TextboxSetText(&window_2, TXB_ID_6, "--");
 	}
 
+	/* statistics panel of the measurement sub-menu */
+	if(showWindow5)
+		DisplayMeasStats();
+
+	/* spectrum timing in the FFT sub-menu */
+	if(showWindow7)
+		dispFFTEngine();
+
+	/* spectrum peak table */
+	dispFFTPeaks();
+
 	return;
 }
 
+/**
+  * @brief  Computes a measurement and formats it for the measurement icons (max. 10 chars).
+  * @param  meas: measurement
+  * @param  buf: output string
+  * @retval None
+  */
+static void measToStr(const Measure_TypeDef* meas, char* buf)
+{
+	static const char timeLabels[][4] = {"T:", "Tr:", "Tf:", "W+:", "W-:"};		/* MEAS_PER..MEAS_NWID */
+	static const char spectralLabels[][6] = {"THD:", "SNR:", "SNDR:", "ENOB:", "SFDR:"};		/* MEAS_THD..MEAS_SFDR */
+
+	if(meas->param == MEAS_FREQ)
+		strcpy(buf, "F:");
+	else if(meas->param == MEAS_DLY)
+		strcpy(buf, "D:");
+	else if(meas->param == MEAS_PHS)
+		strcpy(buf, "Ph:");
+	else if(meas->param >= MEAS_PER && meas->param <= MEAS_NWID)
+		strcpy(buf, timeLabels[meas->param - MEAS_PER]);
+	else if(meas->param >= MEAS_THD && meas->param <= MEAS_SFDR)
+		strcpy(buf, spectralLabels[meas->param - MEAS_THD]);
+	else{
+		strcpy(buf, measParamTexts[meas->param]);
+		strcat(buf, ":");
+	}
+
+	measValToStr(meas->param, scaleMeasure(meas->param, calcMeasure(meas->src, meas->param)), buf + strlen(buf));
+}
+
+/**
+  * @brief  Formats a measurement value with its unit.
+  * @param  param: measurement parameter
+  * @param  val: value in display units, as returned by scaleMeasure()
+  * @param  buf: output string
+  * @retval None
+  */
+static void measValToStr(uint8_t param, float32_t val, char* buf)
+{
+	buf[0] = '\0';
+
+	if(param == MEAS_FREQ){
+		hertzToStr(val, buf);
+	}
+	else if(param == MEAS_DUTY || param == MEAS_OVSH || param == MEAS_PRSH){
+		itoa(val, buf, 10);
+		strcat(buf, "%");
+	}
+	else if(param == MEAS_PHS){
+		itoa(val, buf, 10);
+		strcat(buf, "deg");
+	}
+	else if(param == MEAS_DLY || (param >= MEAS_PER && param <= MEAS_NWID)){
+		if(param != MEAS_DLY && val < 0)
+			strcpy(buf, "--");
+		else
+			secToStr(val, buf);
+	}
+	else if(param >= MEAS_THD && param <= MEAS_SFDR){
+		if(isnan(val)){
+			strcpy(buf, "--");
+		}
+		else if(param == MEAS_ENOB){
+			itoa(val, buf, 10);
+			strcat(buf, ".");
+			itoa((int32_t)(val*10) % 10, buf + strlen(buf), 10);
+		}
+		else{
+			itoa(roundf(val), buf, 10);
+			strcat(buf, "dB");
+		}
+	}
+	else{
+		/* math voltages can be negative */
+		if(val < 0){
+			strcpy(buf, "-");
+			val = -val;
+		}
+		voltsToStr(val, buf);
+	}
+}
+
+/**
+  * @brief  Displays the running statistics of the measurement shown in window 5.
+  * @param  None
+  * @retval None
+  */
+static void DisplayMeasStats(void)
+{
+	static char bufN[12], bufMean[20], bufMin[20], bufMax[20], bufSd[20];
+	Measure_TypeDef* meas;
+	float32_t sd;
+
+	if(wind5OpenedBy == MEASURE1)
+		meas = &measure1;
+	else if(wind5OpenedBy == MEASURE2)
+		meas = &measure2;
+	else if(wind5OpenedBy == MEASURE3)
+		meas = &measure3;
+	else if(wind5OpenedBy == MEASURE4)
+		meas = &measure4;
+	else
+		return;
+
+	UG_ButtonSetText(&window_5, BTN_ID_2, measStatsOn ? "ON" : "OFF");
+
+	strcpy(bufN, "n:");
+	itoa(meas->acc.n, bufN + 2, 10);
+	UG_TextboxSetText(&window_5, TXB_ID_3, bufN);
+
+	strcpy(bufMean, "mean: ");
+	strcpy(bufMin, "min:  ");
+	strcpy(bufMax, "max:  ");
+	strcpy(bufSd, "sd:   ");
+	if(meas->param != MEAS_NONE && meas->acc.n > 0){
+		measValToStr(meas->param, meas->acc.mean, bufMean + 6);
+		measValToStr(meas->param, meas->acc.min, bufMin + 6);
+		measValToStr(meas->param, meas->acc.max, bufMax + 6);
+		sd = 0;
+		if(meas->acc.n > 1)
+			arm_sqrt_f32(meas->acc.m2/(meas->acc.n - 1), &sd);
+		measValToStr(meas->param, sd, bufSd + 6);
+	}
+	UG_TextboxSetText(&window_5, TXB_ID_4, bufMean);
+	UG_TextboxSetText(&window_5, TXB_ID_5, bufMin);
+	UG_TextboxSetText(&window_5, TXB_ID_6, bufMax);
+	UG_TextboxSetText(&window_5, TXB_ID_7, bufSd);
+}
+
 /**
   * @brief  Get currently active field.
   * @param  None
@@ -1687,8 +2380,11 @@ void changeFieldValue(uint8_t dir)
 	static int32_t trigCurPosPrev = 52, ch1offCurPosPrev = 130, ch2offCurPosPrev = 250,
 			toffCurPosPrev = TOFF_INITVAL - TOFF_CURSOR_WIDTH/2 + 1, wind8PosPrev = TOFF_INITVAL + 10;
 	int32_t temp, trigCurPos, ch1offCurPos, ch2offCurPos, toffCurPos, wind8Pos, i, j;
+	uint8_t cursorsMoved = 0;
 	__IO uint16_t (*pFrame)[LCD_WIDTH] = (__IO uint16_t (*)[LCD_WIDTH])LCD_DRAW_BUFFER_UGUI;
 
+	DMA2D_waitBuffer(LCD_DRAW_BUFFER_UGUI);
+
 	/* increment/decrement value of the current field */
 	switch(currField)
 	{
@@ -1832,14 +2528,12 @@ void changeFieldValue(uint8_t dir)
 				else
 					wind8Pos = toff + 10;
 
-				UG_WindowHide(&window_8);
+				UG_WindowSetVisible(&window_8, 0);		/* shown again at the new position by the compositor */
 				fillFrameUGUI(wind8PosPrev, WIND8_Y_START, wind8PosPrev + WIND8_WIDTH - 1, WIND8_Y_START + WIND8_HEIGHT - 1, C_BLACK);
 				UG_WindowResize(&window_8, wind8Pos, WIND8_Y_START, wind8Pos + WIND8_WIDTH - 1, WIND8_Y_START + WIND8_HEIGHT - 1);
 				wind8PosPrev = wind8Pos;
 
-				bufw8tb0[0] = '\0';
-				hertzToStr(0.5f*toff*samprateVals[tscale]/(float32_t)LCD_WIDTH, bufw8tb0);
-				UG_TextboxSetText(&window_8, TXB_ID_0, bufw8tb0);
+				dispFFTFreqs();
 			}
 
 			drawGridVerti();
@@ -1852,7 +2546,7 @@ void changeFieldValue(uint8_t dir)
 	}
 
 	/* if trig source changed, clear off the existing trigger cursor */
-	if(currField == FLD_TRIGSRC){
+	if(currField == FLD_TRIGSRC && chDispMode != CHDISPMODE_XY){
 		for(i = trigCurPosPrev; i < trigCurPosPrev + CURSOR_WIDTH; i++)
 			for(j = 0; j < CURSOR_LENGTH; j++)
 				pFrame[i][j] = trigCursorImg[i-trigCurPosPrev][j] ? CH1_COLOR : C_BLACK;
@@ -1881,7 +2575,7 @@ void changeFieldValue(uint8_t dir)
 			(currField == FLD_TRIGLVL && trigsrcVals[trigsrc] == TRIGSRC_CH1) || currField == FLD_CH1_VOFF ||
 			(chDispMode == CHDISPMODE_MERGE && (currField == FLD_CH2_VSCALE ||
 			(currField == FLD_TRIGLVL && trigsrcVals[trigsrc] == TRIGSRC_CH2) || currField == FLD_CH2_VOFF)) ||
-			dir == 2) && chDispMode != CHDISPMODE_FFT){
+			dir == 2) && chDispMode != CHDISPMODE_FFT && chDispMode != CHDISPMODE_XY){
 
 		if(trigsrcVals[trigsrc] == TRIGSRC_CH1){
 			/* clear previous trigger cursor and redraw */
@@ -1930,8 +2624,7 @@ void changeFieldValue(uint8_t dir)
 				pFrame[i][j] = ch1RefCursorImg[i-ch1offCurPos][j] ? CH1_COLOR : C_BLACK;
 
 		ch1offCurPosPrev = ch1offCurPos;
-
-		drawGridHoriz();
+		cursorsMoved = 1;
 	}
 
 	/* Update the positions of ch2 cursors, if required */
@@ -1939,7 +2632,7 @@ void changeFieldValue(uint8_t dir)
 			(currField == FLD_TRIGLVL && trigsrcVals[trigsrc] == TRIGSRC_CH2) || currField == FLD_CH2_VOFF ||
 			(chDispMode == CHDISPMODE_MERGE && (currField == FLD_CH1_VSCALE ||
 			(currField == FLD_TRIGLVL && trigsrcVals[trigsrc] == TRIGSRC_CH1) || currField == FLD_CH1_VOFF)) ||
-			dir == 2) && chDispMode != CHDISPMODE_SNGL && chDispMode != CHDISPMODE_FFT){
+			dir == 2) && chDispMode != CHDISPMODE_SNGL && chDispMode != CHDISPMODE_FFT && chDispMode != CHDISPMODE_XY){
 
 		if(trigsrcVals[trigsrc] == TRIGSRC_CH2){
 			/* clear previous trigger cursor and redraw */
@@ -1989,21 +2682,22 @@ void changeFieldValue(uint8_t dir)
 				pFrame[i][j] = ch2RefCursorImg[i-ch2offCurPos][j] ? CH2_COLOR : C_BLACK;
 
 		ch2offCurPosPrev = ch2offCurPos;
-
-		drawGridHoriz();
+		cursorsMoved = 1;
 	}
 
+	/* grid under the cursors, queued once after all the CPU cursor writes as it runs on the DMA2D */
+	if(cursorsMoved)
+		drawGridRect(0, MENUBAR_HEIGHT, CURSOR_LENGTH - 1, LCD_HEIGHT - MENUBAR_HEIGHT - 1);
+
 	/* update horizontal offset if there is a change in time scale */
 	if(currField == FLD_TSCALE){
 		secToStr((float32_t)(toff-LCD_WIDTH/2)/(float32_t)samprateVals[tscale], bufw2tb2);
 		UG_TextboxSetText(&window_2, TXB_ID_2, bufw2tb2);
 	}
 
-	/* update frequency display value */
+	/* update frequency display values */
 	if(chDispMode == CHDISPMODE_FFT && currField == FLD_TSCALE){
-		bufw8tb0[0] = '\0';
-		hertzToStr(0.5f*toff*samprateVals[tscale]/(float32_t)LCD_WIDTH, bufw8tb0);
-		UG_TextboxSetText(&window_8, TXB_ID_0, bufw8tb0);
+		dispFFTFreqs();
 	}
 
 	/* redraw cursors, if required */
@@ -2025,6 +2719,8 @@ void dispToff(void)
 	int32_t toffCurPos, i, j;
 	__IO uint16_t (*pFrame)[LCD_WIDTH] = (__IO uint16_t (*)[LCD_WIDTH])LCD_DRAW_BUFFER_UGUI;
 
+	DMA2D_waitBuffer(LCD_DRAW_BUFFER_UGUI);
+
 	secToStr((float32_t)(toff-LCD_WIDTH/2)/(float32_t)samprateVals[tscale], bufw2tb2);
 	UG_TextboxSetText(&window_2, TXB_ID_2, bufw2tb2);
 
@@ -2051,6 +2747,8 @@ void changeFieldValueMath(int8_t dir)
 	int32_t voffCurPos, temp, i, j;
 	__IO uint16_t (*pFrame)[LCD_WIDTH] = (__IO uint16_t (*)[LCD_WIDTH])LCD_DRAW_BUFFER_UGUI;
 
+	DMA2D_waitBuffer(LCD_DRAW_BUFFER_UGUI);
+
 	if(mathField == MATHFLD_VOFF){
 		/* clear previous offset cursor */
 		for(i = voffCurPosPrev; i < voffCurPosPrev + CURSOR_WIDTH; i++)
@@ -2073,6 +2771,7 @@ void changeFieldValueMath(int8_t dir)
 			voffCurPosPrev = voffCurPos;
 
 			if(dir != 2){
+				mathChanged = 1;
 				gcvt((int32_t)((3.3f*(float32_t)mathVoff/(float32_t)255)*100)/100.0f, 3 + (mathVoff < -1), bufw9btn2);
 				strcat(bufw9btn2, "V");
 				UG_ButtonSetText(&window_9, BTN_ID_2, bufw9btn2);
@@ -2085,6 +2784,7 @@ void changeFieldValueMath(int8_t dir)
 	else if(mathField == MATHFLD_VSCALE && dir != 2 && dir != -1){
 		mathVscale += dir?(mathVscale==0?0:-1):(mathVscale==VSCALE_MAXVALS-1?0:1);
 		UG_ButtonSetText(&window_9, BTN_ID_1, vscaleDispVals[mathVscale]);
+		mathChanged = 1;
 
 		/* clear previous offset cursor */
 		for(i = voffCurPosPrev; i < voffCurPosPrev + CURSOR_WIDTH; i++)
@@ -2116,6 +2816,8 @@ void changeFieldValueCursor(int8_t dir)
 	int32_t temp, i, j;
 	__IO uint16_t (*pFrame)[LCD_WIDTH] = (__IO uint16_t (*)[LCD_WIDTH])LCD_DRAW_BUFFER_UGUI;
 
+	DMA2D_waitBuffer(LCD_DRAW_BUFFER_UGUI);
+
 	/* clear previous cursors */
 	if(cursorMode == CURSOR_MODE_DT){
 		for(i = CHDISPMODE_MERGE_CHTOP; i <= CHDISPMODE_MERGE_CHBOT - 2; i += 6){
@@ -2129,6 +2831,7 @@ void changeFieldValueCursor(int8_t dir)
 			pFrame[cursorBpos][j] = pFrame[cursorBpos][j + 1] = pFrame[cursorBpos][j + 2] = C_BLACK;
 		}
 	}
+	invalidateCursorLines();
 
 	if(dir != -1){
 		if(dir != 2 && cursorField != CURSORFLD_NONE){
@@ -2163,6 +2866,7 @@ void changeFieldValueCursor(int8_t dir)
 				pFrame[cursorBpos][j] = pFrame[cursorBpos][j + 1] = pFrame[cursorBpos][j + 2] = CURSOR_COLOR;
 			}
 		}
+		invalidateCursorLines();
 
 		/* calculate cursor position values */
 		if(chDispMode == CHDISPMODE_SPLIT && cursorMode == CURSOR_MODE_DVCH1){
@@ -2230,6 +2934,9 @@ void changeFieldValueCursor(int8_t dir)
 			drawRedBorder();
 		}
 	}
+
+	/* the measurement gate follows the dT cursors */
+	setMeasGate(cursorGate && cursorMode == CURSOR_MODE_DT && dir != -1, cursorApos, cursorBpos);
 }
 
 /**
@@ -2262,6 +2969,8 @@ void initFields(void)
 	int32_t temp, curPos, i, j;
 	__IO uint16_t (*pFrame)[LCD_WIDTH] = (__IO uint16_t (*)[LCD_WIDTH])LCD_DRAW_BUFFER_UGUI;
 
+	DMA2D_waitBuffer(LCD_DRAW_BUFFER_UGUI);
+
 	/* ch1 vertical scale */
 	UG_TextboxSetText(&window_1, TXB_ID_0, vscaleDispVals[vscale1]);
 
@@ -2413,6 +3122,9 @@ void drawRedBorder(void)
 	UG_DrawLine(LCD_WIDTH - 1, MENUBAR_HEIGHT, LCD_WIDTH - 1, LCD_HEIGHT - MENUBAR_HEIGHT - 1, C_RED);
 	UG_DrawLine(LCD_WIDTH - 2, MENUBAR_HEIGHT, LCD_WIDTH - 2, LCD_HEIGHT - MENUBAR_HEIGHT - 1, C_RED);
 
+	/* the border is drawn across the menus */
+	invalidateWindows(0, MENUBAR_HEIGHT, LCD_WIDTH - 1, LCD_HEIGHT - MENUBAR_HEIGHT - 1);
+
 	return;
 }
 
@@ -2450,11 +3162,11 @@ void clearRedBorder(void)
 void displayInfo(const char* text, uint32_t duration)
 {
 	UG_TextboxSetText(&window_11, TXB_ID_0, text);
-	UG_WindowShow(&window_11);
-	UG_Update();
+	UG_WindowSetVisible(&window_11, 1);
+	UG_WindowUpdate(&window_11);
 	updateToScreen();
 	LL_mDelay(duration);
-	UG_WindowHide(&window_11);
+	UG_WindowSetVisible(&window_11, 0);
 	fillFrameUGUI(WIND11_X_START, WIND11_Y_START, WIND11_X_START + WIND11_WIDTH - 1, WIND11_Y_START + WIND11_HEIGHT - 1, C_BLACK);
 	drawGrid();
 }
@@ -2483,6 +3195,7 @@ void captureScreenshot(void)
 		itoa(maxfilename, filename, 10);							/* name the files starting from "1.bmp" */
 		strcat(filename, ".bmp");
 
+		DMA2D_waitBuffer(LCD_FRAME_BUFFER);		/* last screen update must be complete */
 		raw2bmp((uint8_t *)LCD_FRAME_BUFFER, LCD_WIDTH*LCD_HEIGHT, (uint8_t *)BMP_BUFFER);		/* convert to BMP format */
 		f_open(&fp, filename, FA_CREATE_ALWAYS | FA_WRITE);
 		f_write(&fp, (const void *)BMP_BUFFER, BMP_FILE_SZ, &bytesTfr);
@@ -2563,6 +3276,7 @@ void displayScreenshot(uint16_t x)
 			return;
 		}
 
+		DMA2D_waitBuffer(LCD_FRAME_BUFFER);
 		bmp2raw((const uint8_t *)BMP_BUFFER, LCD_WIDTH*LCD_HEIGHT, (uint8_t *)LCD_FRAME_BUFFER);
 	}
 